@@ -4,11 +4,16 @@
 #include <m03gagbhsvr0m5w15urj0o291m_process/process.h>
 
 #include <format>
+#include <fstream>
+#include <optional>
 #include <stdexcept>
 #include <string>
 #include <string_view>
 #include <type_traits>
 #include <utility>
+#include <variant>
+
+#include <unistd.h>
 
 #ifndef M03GAGBHSMHR0NAW0ZPCCV4GAQ_CXX_TOOLCHAIN_CXX_COMPILER_PATH
 # error M03GAGBHSMHR0NAW0ZPCCV4GAQ_CXX_TOOLCHAIN_CXX_COMPILER_PATH must be defined by bootstrap
@@ -65,12 +70,65 @@ static std::string cxx_string_literal_replacement(const std::string& value) {
     return result;
 }
 
+// Linux bounds the combined size of a command line and its environment; longer argument lists go through a response file.
+static constexpr std::size_t RESPONSE_FILE_THRESHOLD = 32 * 1024;
+
+static std::string process_arg_string(const m03gagbhsvr0m5w15urj0o291m_process::process_arg_t& process_arg) {
+    if (const auto* path = std::get_if<m03gagbhsnusi43zogoacgj2ez_filesystem::path_t>(&process_arg)) {
+        return path->string();
+    }
+
+    return std::get<std::string>(process_arg);
+}
+
+/**
+ * Runs process_args, passing everything after the program through @response_file when the command line is long.
+ * GCC, Clang and GNU ar read whitespace-separated arguments with backslash escapes from it.
+ */
+static void run_checked(
+    const std::vector<m03gagbhsvr0m5w15urj0o291m_process::process_arg_t>& process_args,
+    const m03gagbhsnusi43zogoacgj2ez_filesystem::path_t& response_file
+) {
+    std::size_t command_line_size = 0;
+    for (const auto& process_arg : process_args) {
+        command_line_size += process_arg_string(process_arg).size() + 1;
+    }
+
+    if (command_line_size <= RESPONSE_FILE_THRESHOLD) {
+        m03gagbhsvr0m5w15urj0o291m_process::create_and_wait_checked(m03gagbhsvr0m5w15urj0o291m_process::command_t { .args = process_args });
+        return ;
+    }
+
+    {
+        std::ofstream ofs(response_file.string(), std::ios::binary | std::ios::trunc);
+        for (std::size_t i = 1; i < process_args.size(); ++i) {
+            for (const char c : process_arg_string(process_args[i])) {
+                if (c == '\\' || c == '"' || c == '\'' || c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\v' || c == '\f') {
+                    ofs.put('\\');
+                }
+                ofs.put(c);
+            }
+            ofs.put('\n');
+        }
+
+        if (!ofs) {
+            throw std::runtime_error(std::format("m03gagbhsmhr0naw0zpccv4gaq_cxx_toolchain::run_checked: failed to write response file '{}'", response_file));
+        }
+    }
+
+    m03gagbhsvr0m5w15urj0o291m_process::create_and_wait_checked(m03gagbhsvr0m5w15urj0o291m_process::command_t {
+        .args = { process_args.front(), std::format("@{}", response_file) }
+    });
+    m03gagbhsnusi43zogoacgj2ez_filesystem::remove(response_file);
+}
+
 static std::vector<m03gagbhsnusi43zogoacgj2ez_filesystem::path_t> build_object_files(
     const m03gagbhsnusi43zogoacgj2ez_filesystem::path_t& build_dir,
     const std::vector<m03gagbhsnusi43zogoacgj2ez_filesystem::path_t>& include_dirs,
     const std::vector<m03gagbhsnusi43zogoacgj2ez_filesystem::rooted_path_t>& source_files,
     const std::vector<define_t>& defines,
-    bool is_position_independent
+    bool is_position_independent,
+    bool reuse_existing_objects
 ) {
     std::vector<m03gagbhsnusi43zogoacgj2ez_filesystem::path_t> result;
     result.reserve(source_files.size());
@@ -100,11 +158,19 @@ static std::vector<m03gagbhsnusi43zogoacgj2ez_filesystem::path_t> build_object_f
         auto object_file = build_dir / source_file.relative_path();
         object_file.extension(".o");
 
+        if (reuse_existing_objects && m03gagbhsnusi43zogoacgj2ez_filesystem::exists(object_file)) {
+            result.push_back(object_file);
+            continue ;
+        }
+
         const auto object_file_dir = object_file.parent();
         if (!m03gagbhsnusi43zogoacgj2ez_filesystem::exists(object_file_dir)) {
             m03gagbhsnusi43zogoacgj2ez_filesystem::create_directories(object_file_dir);
         }
 
+        // A reused object must be complete, so it only appears under its name once the compiler succeeded.
+        const auto compiled_file = reuse_existing_objects ? object_file + std::format(".{}_tmp", ::getpid()) : object_file;
+
         std::vector<m03gagbhsvr0m5w15urj0o291m_process::process_arg_t> process_args;
         if (source_path.extension() == ".c") {
             process_args.push_back(M03GAGBHSMHR0NAW0ZPCCV4GAQ_CXX_TOOLCHAIN_CC_COMPILER_PATH);
@@ -119,9 +185,13 @@ static std::vector<m03gagbhsnusi43zogoacgj2ez_filesystem::path_t> build_object_f
         process_args.push_back("-c");
         process_args.push_back(source_path);
         process_args.push_back("-o");
-        process_args.push_back(object_file);
+        process_args.push_back(compiled_file);
 
-        m03gagbhsvr0m5w15urj0o291m_process::create_and_wait_checked(m03gagbhsvr0m5w15urj0o291m_process::command_t { .args = process_args });
+        run_checked(process_args, compiled_file + ".rsp");
+
+        if (compiled_file != object_file) {
+            m03gagbhsnusi43zogoacgj2ez_filesystem::rename_replace(compiled_file, object_file);
+        }
 
         result.push_back(object_file);
     }
@@ -141,20 +211,9 @@ static void append_runtime_library_paths(
 }
 
 static m03gagbhsnusi43zogoacgj2ez_filesystem::path_t build_archive_library_impl(
-    const m03gagbhsnusi43zogoacgj2ez_filesystem::path_t& build_dir,
-    const std::vector<m03gagbhsnusi43zogoacgj2ez_filesystem::path_t>& include_dirs,
-    const std::vector<m03gagbhsnusi43zogoacgj2ez_filesystem::rooted_path_t>& source_files,
-    const std::vector<define_t>& defines,
+    const std::vector<m03gagbhsnusi43zogoacgj2ez_filesystem::path_t>& object_files,
     const m03gagbhsnusi43zogoacgj2ez_filesystem::path_t& static_library
 ) {
-    const auto object_files = build_object_files(
-        build_dir,
-        include_dirs,
-        source_files,
-        defines,
-        false
-    );
-
     const auto static_library_dir = static_library.parent();
     if (!m03gagbhsnusi43zogoacgj2ez_filesystem::exists(static_library_dir)) {
         m03gagbhsnusi43zogoacgj2ez_filesystem::create_directories(static_library_dir);
@@ -168,7 +227,7 @@ static m03gagbhsnusi43zogoacgj2ez_filesystem::path_t build_archive_library_impl(
         process_args.push_back(object_file);
     }
 
-    m03gagbhsvr0m5w15urj0o291m_process::create_and_wait_checked(m03gagbhsvr0m5w15urj0o291m_process::command_t { .args = process_args });
+    run_checked(process_args, static_library + ".rsp");
 
     if (!m03gagbhsnusi43zogoacgj2ez_filesystem::exists(static_library)) {
         throw std::runtime_error(std::format("m03gagbhsmhr0naw0zpccv4gaq_cxx_toolchain::build_library: expected output static library '{}' to exist but it does not", static_library));
@@ -178,21 +237,10 @@ static m03gagbhsnusi43zogoacgj2ez_filesystem::path_t build_archive_library_impl(
 }
 
 static m03gagbhsnusi43zogoacgj2ez_filesystem::path_t build_dynamic_library_impl(
-    const m03gagbhsnusi43zogoacgj2ez_filesystem::path_t& build_dir,
-    const std::vector<m03gagbhsnusi43zogoacgj2ez_filesystem::path_t>& include_dirs,
-    const std::vector<m03gagbhsnusi43zogoacgj2ez_filesystem::rooted_path_t>& source_files,
-    const std::vector<define_t>& defines,
+    const std::vector<m03gagbhsnusi43zogoacgj2ez_filesystem::path_t>& object_files,
     const link_inputs_t& link_inputs,
     const m03gagbhsnusi43zogoacgj2ez_filesystem::path_t& shared_library
 ) {
-    const auto object_files = build_object_files(
-        build_dir,
-        include_dirs,
-        source_files,
-        defines,
-        true
-    );
-
     const auto shared_library_dir = shared_library.parent();
     if (!m03gagbhsnusi43zogoacgj2ez_filesystem::exists(shared_library_dir)) {
         m03gagbhsnusi43zogoacgj2ez_filesystem::create_directories(shared_library_dir);
@@ -226,7 +274,7 @@ static m03gagbhsnusi43zogoacgj2ez_filesystem::path_t build_dynamic_library_impl(
 
     append_runtime_library_paths(process_args, link_inputs);
 
-    m03gagbhsvr0m5w15urj0o291m_process::create_and_wait_checked(m03gagbhsvr0m5w15urj0o291m_process::command_t { .args = process_args });
+    run_checked(process_args, shared_library + ".rsp");
 
     if (!m03gagbhsnusi43zogoacgj2ez_filesystem::exists(shared_library)) {
         throw std::runtime_error(std::format("m03gagbhsmhr0naw0zpccv4gaq_cxx_toolchain::build_library: expected output shared library '{}' to exist but it does not", shared_library));
@@ -235,22 +283,16 @@ static m03gagbhsnusi43zogoacgj2ez_filesystem::path_t build_dynamic_library_impl(
     return shared_library;
 }
 
+/**
+ * Links binary. With runpath_capacity, libraries are recorded by file name and the run path is a placeholder of
+ * that many bytes: '/' never ends another dynamic string, so the linker cannot merge one into its tail.
+ */
 static m03gagbhsnusi43zogoacgj2ez_filesystem::path_t build_binary_impl(
-    const m03gagbhsnusi43zogoacgj2ez_filesystem::path_t& build_dir,
-    const std::vector<m03gagbhsnusi43zogoacgj2ez_filesystem::path_t>& include_dirs,
-    const std::vector<m03gagbhsnusi43zogoacgj2ez_filesystem::rooted_path_t>& source_files,
-    const std::vector<define_t>& defines,
+    const std::vector<m03gagbhsnusi43zogoacgj2ez_filesystem::path_t>& object_files,
     const link_inputs_t& link_inputs,
+    std::optional<std::size_t> runpath_capacity,
     const m03gagbhsnusi43zogoacgj2ez_filesystem::path_t& binary
 ) {
-    const auto object_files = build_object_files(
-        build_dir,
-        include_dirs,
-        source_files,
-        defines,
-        true
-    );
-
     const auto binary_dir = binary.parent();
     if (!m03gagbhsnusi43zogoacgj2ez_filesystem::exists(binary_dir)) {
         m03gagbhsnusi43zogoacgj2ez_filesystem::create_directories(binary_dir);
@@ -274,16 +316,26 @@ static m03gagbhsnusi43zogoacgj2ez_filesystem::path_t build_binary_impl(
             if (!m03gagbhsnusi43zogoacgj2ez_filesystem::exists(library)) {
                 throw std::runtime_error(std::format("m03gagbhsmhr0naw0zpccv4gaq_cxx_toolchain::build_binary: library does not exist '{}'", library));
             }
-            process_args.push_back(library);
+
+            if (runpath_capacity) {
+                process_args.push_back(std::format("-L{}", library.parent()));
+                process_args.push_back(std::format("-l:{}", library.filename()));
+            } else {
+                process_args.push_back(library);
+            }
         }
         if (group.static_library_group) {
             process_args.push_back("-Wl,--end-group");
         }
     }
 
-    append_runtime_library_paths(process_args, link_inputs);
+    if (runpath_capacity) {
+        process_args.push_back(std::format("-Wl,-rpath,{}", std::string(*runpath_capacity, '/')));
+    } else {
+        append_runtime_library_paths(process_args, link_inputs);
+    }
 
-    m03gagbhsvr0m5w15urj0o291m_process::create_and_wait_checked(m03gagbhsvr0m5w15urj0o291m_process::command_t { .args = process_args });
+    run_checked(process_args, binary + ".rsp");
 
     if (!m03gagbhsnusi43zogoacgj2ez_filesystem::exists(binary)) {
         throw std::runtime_error(std::format("m03gagbhsmhr0naw0zpccv4gaq_cxx_toolchain::build_binary: expected output binary '{}' to exist but it does not", binary));
@@ -318,31 +370,20 @@ m03gagbhsnusi43zogoacgj2ez_filesystem::path_t build_library(
     const link_inputs_t& link_inputs,
     const m03gagbhsnusi43zogoacgj2ez_filesystem::path_t& output_path
 ) {
-    switch (library_type) {
-        case library_type_t::STATIC:
-            if (!link_inputs.groups.empty()) {
-                throw std::runtime_error("m03gagbhsmhr0naw0zpccv4gaq_cxx_toolchain::build_library: static libraries do not support link inputs");
-            }
-
-            return build_archive_library_impl(
-                build_dir,
-                include_dirs,
-                source_files,
-                defines,
-                output_path
-            );
-        case library_type_t::SHARED:
-            return build_dynamic_library_impl(
-                build_dir,
-                include_dirs,
-                source_files,
-                defines,
-                link_inputs,
-                output_path
-            );
-        default:
-            throw std::runtime_error(std::format("m03gagbhsmhr0naw0zpccv4gaq_cxx_toolchain::build_library: unknown library_type {}", static_cast<std::underlying_type_t<library_type_t>>(library_type)));
+    if (library_type == library_type_t::STATIC && !link_inputs.groups.empty()) {
+        throw std::runtime_error("m03gagbhsmhr0naw0zpccv4gaq_cxx_toolchain::build_library: static libraries do not support link inputs");
     }
+
+    const auto object_files = build_object_files(
+        build_dir,
+        include_dirs,
+        source_files,
+        defines,
+        library_type == library_type_t::SHARED,
+        false
+    );
+
+    return link_library(object_files, library_type, link_inputs, output_path);
 }
 
 m03gagbhsnusi43zogoacgj2ez_filesystem::path_t build_binary(
@@ -353,14 +394,69 @@ m03gagbhsnusi43zogoacgj2ez_filesystem::path_t build_binary(
     const link_inputs_t& link_inputs,
     const m03gagbhsnusi43zogoacgj2ez_filesystem::path_t& output_path
 ) {
-    return build_binary_impl(
+    const auto object_files = build_object_files(
         build_dir,
         include_dirs,
         source_files,
         defines,
-        link_inputs,
-        output_path
+        true,
+        false
+    );
+
+    return build_binary_impl(object_files, link_inputs, std::nullopt, output_path);
+}
+
+std::vector<m03gagbhsnusi43zogoacgj2ez_filesystem::path_t> build_objects(
+    const m03gagbhsnusi43zogoacgj2ez_filesystem::path_t& object_dir,
+    const std::vector<m03gagbhsnusi43zogoacgj2ez_filesystem::path_t>& include_dirs,
+    const std::vector<m03gagbhsnusi43zogoacgj2ez_filesystem::rooted_path_t>& source_files,
+    const std::vector<define_t>& defines
+) {
+    return build_object_files(
+        object_dir,
+        include_dirs,
+        source_files,
+        defines,
+        true,
+        true
     );
 }
 
+m03gagbhsnusi43zogoacgj2ez_filesystem::path_t link_library(
+    const std::vector<m03gagbhsnusi43zogoacgj2ez_filesystem::path_t>& object_files,
+    library_type_t library_type,
+    const link_inputs_t& link_inputs,
+    const m03gagbhsnusi43zogoacgj2ez_filesystem::path_t& output_path
+) {
+    switch (library_type) {
+        case library_type_t::STATIC:
+            if (!link_inputs.groups.empty()) {
+                throw std::runtime_error("m03gagbhsmhr0naw0zpccv4gaq_cxx_toolchain::link_library: static libraries do not support link inputs");
+            }
+
+            return build_archive_library_impl(object_files, output_path);
+        case library_type_t::SHARED:
+            return build_dynamic_library_impl(object_files, link_inputs, output_path);
+        default:
+            throw std::runtime_error(std::format("m03gagbhsmhr0naw0zpccv4gaq_cxx_toolchain::link_library: unknown library_type {}", static_cast<std::underlying_type_t<library_type_t>>(library_type)));
+    }
+}
+
+m03gagbhsnusi43zogoacgj2ez_filesystem::path_t link_binary(
+    const std::vector<m03gagbhsnusi43zogoacgj2ez_filesystem::path_t>& object_files,
+    const link_inputs_t& link_inputs,
+    const m03gagbhsnusi43zogoacgj2ez_filesystem::path_t& output_path
+) {
+    return build_binary_impl(object_files, link_inputs, std::nullopt, output_path);
+}
+
+m03gagbhsnusi43zogoacgj2ez_filesystem::path_t link_binary_with_runpath_placeholder(
+    const std::vector<m03gagbhsnusi43zogoacgj2ez_filesystem::path_t>& object_files,
+    const link_inputs_t& link_inputs,
+    std::size_t runpath_capacity,
+    const m03gagbhsnusi43zogoacgj2ez_filesystem::path_t& output_path
+) {
+    return build_binary_impl(object_files, link_inputs, runpath_capacity, output_path);
+}
+
 } // namespace m03gagbhsmhr0naw0zpccv4gaq_cxx_toolchain
@@ -80,6 +80,54 @@ m03gagbhsnusi43zogoacgj2ez_filesystem::path_t build_binary(
     const m03gagbhsnusi43zogoacgj2ez_filesystem::path_t& output_path
 );
 
+/**
+ * Compiles source_files into position-independent objects under object_dir, usable by both library types and binaries.
+ *
+ * Objects already in object_dir are reused, so object_dir must be specific to the compile inputs.
+ */
+std::vector<m03gagbhsnusi43zogoacgj2ez_filesystem::path_t> build_objects(
+    const m03gagbhsnusi43zogoacgj2ez_filesystem::path_t& object_dir,
+    const std::vector<m03gagbhsnusi43zogoacgj2ez_filesystem::path_t>& include_dirs,
+    const std::vector<m03gagbhsnusi43zogoacgj2ez_filesystem::rooted_path_t>& source_files,
+    const std::vector<define_t>& defines
+);
+
+/**
+ * Archives or links object_files into a static or shared library at output_path.
+ *
+ * The returned path is output_path. For static libraries, pass empty link_inputs.
+ */
+m03gagbhsnusi43zogoacgj2ez_filesystem::path_t link_library(
+    const std::vector<m03gagbhsnusi43zogoacgj2ez_filesystem::path_t>& object_files,
+    library_type_t library_type,
+    const link_inputs_t& link_inputs,
+    const m03gagbhsnusi43zogoacgj2ez_filesystem::path_t& output_path
+);
+
+/**
+ * Links object_files into an executable at output_path.
+ *
+ * The returned path is output_path.
+ */
+m03gagbhsnusi43zogoacgj2ez_filesystem::path_t link_binary(
+    const std::vector<m03gagbhsnusi43zogoacgj2ez_filesystem::path_t>& object_files,
+    const link_inputs_t& link_inputs,
+    const m03gagbhsnusi43zogoacgj2ez_filesystem::path_t& output_path
+);
+
+/**
+ * Links object_files into an executable at output_path like link_binary(), but records libraries by file name
+ * and reserves a run path of runpath_capacity bytes for the caller to patch in their directories.
+ *
+ * The returned path is output_path.
+ */
+m03gagbhsnusi43zogoacgj2ez_filesystem::path_t link_binary_with_runpath_placeholder(
+    const std::vector<m03gagbhsnusi43zogoacgj2ez_filesystem::path_t>& object_files,
+    const link_inputs_t& link_inputs,
+    std::size_t runpath_capacity,
+    const m03gagbhsnusi43zogoacgj2ez_filesystem::path_t& output_path
+);
+
 } // namespace m03gagbhsmhr0naw0zpccv4gaq_cxx_toolchain
 
 #endif // M03GAGBHSMHR0NAW0ZPCCV4GAQ_CXX_TOOLCHAIN_H
@@ -4,6 +4,17 @@
 #include <algorithm>
 #include <iostream>
 #include <fstream>
+#include <set>
+#include <utility>
+
+#include <cerrno>
+#include <cstring>
+
+#include <fcntl.h>
+#include <linux/fs.h>
+#include <sys/ioctl.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 namespace m03gagbhsnusi43zogoacgj2ez_filesystem {
 
@@ -391,6 +402,68 @@ void copy(const path_t& src, const path_t& dst) {
     }
 }
 
+bool clone_file(const path_t& src, const path_t& dst) {
+    const auto parent = dst.parent();
+    if (!exists(parent)) {
+        create_directories(parent);
+    }
+
+    const int src_fd = ::open(src.c_str(), O_RDONLY | O_CLOEXEC);
+    if (src_fd == -1) {
+        throw std::runtime_error(std::format("m03gagbhsnusi43zogoacgj2ez_filesystem::clone_file: failed to open '{}': {}", src, std::strerror(errno)));
+    }
+
+    struct stat src_stat;
+    if (::fstat(src_fd, &src_stat) == -1) {
+        const int error = errno;
+        ::close(src_fd);
+        throw std::runtime_error(std::format("m03gagbhsnusi43zogoacgj2ez_filesystem::clone_file: failed to stat '{}': {}", src, std::strerror(error)));
+    }
+
+    const int dst_fd = ::open(dst.c_str(), O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC, src_stat.st_mode & 07777);
+    if (dst_fd == -1) {
+        const int error = errno;
+        ::close(src_fd);
+        throw std::runtime_error(std::format("m03gagbhsnusi43zogoacgj2ez_filesystem::clone_file: failed to create '{}': {}", dst, std::strerror(error)));
+    }
+
+    const int result = ::ioctl(dst_fd, FICLONE, src_fd);
+    const int error = errno;
+    ::close(dst_fd);
+    ::close(src_fd);
+
+    if (result == 0) {
+        std::cout << std::format("cp --reflink=always {} {}", pretty_path_t(src), pretty_path_t(dst)) << std::endl;
+        return true;
+    }
+
+    ::unlink(dst.c_str());
+    if (error == EOPNOTSUPP || error == ENOTTY || error == EXDEV || error == EINVAL || error == ENOSYS) {
+        return false;
+    }
+
+    throw std::runtime_error(std::format("m03gagbhsnusi43zogoacgj2ez_filesystem::clone_file: failed to clone '{}' to '{}': {}", src, dst, std::strerror(error)));
+}
+
+bool create_hard_link(const path_t& src, const path_t& dst) {
+    const auto parent = dst.parent();
+    if (!exists(parent)) {
+        create_directories(parent);
+    }
+
+    if (::link(src.c_str(), dst.c_str()) == 0) {
+        std::cout << std::format("ln {} {}", pretty_path_t(src), pretty_path_t(dst)) << std::endl;
+        return true;
+    }
+
+    const int error = errno;
+    if (error == EXDEV || error == EPERM || error == EOPNOTSUPP || error == EMLINK) {
+        return false;
+    }
+
+    throw std::runtime_error(std::format("m03gagbhsnusi43zogoacgj2ez_filesystem::create_hard_link: failed to link '{}' to '{}': {}", dst, src, std::strerror(error)));
+}
+
 void touch(const path_t& path) {
     // std::cout << std::format("touch {}", pretty_path_t(path)) << std::endl;
 
@@ -503,6 +576,25 @@ std::filesystem::file_time_type last_write_time(const path_t& path) {
     return result;
 }
 
+std::filesystem::file_time_type latest_write_time(const path_t& directory) {
+    auto result = last_write_time(directory);
+
+    // Native paths straight from the iterator: normalizing a path_t per entry dominates the cost of a stat.
+    std::error_code ec;
+    for (std::filesystem::recursive_directory_iterator it(directory.to_native_path(), ec), end; !ec && it != end; it.increment(ec)) {
+        const auto write_time = std::filesystem::last_write_time(it->path(), ec);
+        if (ec) {
+            throw std::runtime_error(std::format("m03gagbhsnusi43zogoacgj2ez_filesystem::latest_write_time: failed to get last write time of path '{}': {}", it->path().string(), ec.message()));
+        }
+        result = std::max(result, write_time);
+    }
+    if (ec) {
+        throw std::runtime_error(std::format("m03gagbhsnusi43zogoacgj2ez_filesystem::latest_write_time: failed to traverse '{}': {}", directory, ec.message()));
+    }
+
+    return result;
+}
+
 bool remove(const path_t& path) {
     // std::cout << std::format("rm {}", pretty_path_t(path)) << std::endl;
 
@@ -571,4 +663,151 @@ bool is_directory(const path_t& path) {
     return result;
 }
 
+std::uintmax_t hard_link_count(const path_t& path) {
+    // std::cout << std::format("stat -c%h {}", pretty_path_t(path)) << std::endl;
+
+    std::error_code ec;
+    const std::uintmax_t result = std::filesystem::hard_link_count(path.to_native_path(), ec);
+    if (ec) {
+        throw std::runtime_error(std::format("m03gagbhsnusi43zogoacgj2ez_filesystem::hard_link_count: failed to get hard link count of path '{}': {}", path, ec.message()));
+    }
+    return result;
+}
+
+std::filesystem::perms permissions(const path_t& path) {
+    // std::cout << std::format("stat -c%a {}", pretty_path_t(path)) << std::endl;
+
+    std::error_code ec;
+    const auto result = std::filesystem::status(path.to_native_path(), ec);
+    if (ec) {
+        throw std::runtime_error(std::format("m03gagbhsnusi43zogoacgj2ez_filesystem::permissions: failed to get permissions of path '{}': {}", path, ec.message()));
+    }
+    return result.permissions();
+}
+
+void permissions(const path_t& path, std::filesystem::perms permissions) {
+    // std::cout << std::format("chmod {:o} {}", static_cast<unsigned>(permissions), pretty_path_t(path)) << std::endl;
+
+    std::error_code ec;
+    std::filesystem::permissions(path.to_native_path(), permissions, std::filesystem::perm_options::replace, ec);
+    if (ec) {
+        throw std::runtime_error(std::format("m03gagbhsnusi43zogoacgj2ez_filesystem::permissions: failed to set permissions of path '{}': {}", path, ec.message()));
+    }
+}
+
+bool is_symlink(const path_t& path) {
+    // std::cout << std::format("test -L {}", pretty_path_t(path)) << std::endl;
+
+    std::error_code ec;
+    const bool result = std::filesystem::is_symlink(path.to_native_path(), ec);
+    if (ec) {
+        throw std::runtime_error(std::format("m03gagbhsnusi43zogoacgj2ez_filesystem::is_symlink: failed to check if path '{}' is a symbolic link: {}", path, ec.message()));
+    }
+    return result;
+}
+
+path_t read_symlink(const path_t& path) {
+    // std::cout << std::format("readlink {}", pretty_path_t(path)) << std::endl;
+
+    std::error_code ec;
+    const auto target = std::filesystem::read_symlink(path.to_native_path(), ec);
+    if (ec) {
+        throw std::runtime_error(std::format("m03gagbhsnusi43zogoacgj2ez_filesystem::read_symlink: failed to read symbolic link '{}': {}", path, ec.message()));
+    }
+    if (target.is_absolute()) {
+        return path_t(target);
+    }
+    return path_t(path.parent().to_native_path() / target);
+}
+
+std::uintmax_t disk_usage_t::add(const path_t& path) {
+    // std::cout << std::format("du -s {}", pretty_path_t(path)) << std::endl;
+
+    const auto total_before = m_total;
+    bool is_directory = false;
+    const auto add = [&](const std::filesystem::path& native_path) {
+        struct stat st;
+        if (::lstat(native_path.c_str(), &st) == -1) {
+            throw std::runtime_error(std::format("m03gagbhsnusi43zogoacgj2ez_filesystem::disk_usage_t::add: failed to stat '{}': {}", native_path.string(), std::strerror(errno)));
+        }
+        if (st.st_nlink <= 1 || m_counted.emplace(st.st_dev, st.st_ino).second) {
+            m_total += static_cast<std::uintmax_t>(st.st_blocks) * 512;
+        }
+        is_directory = S_ISDIR(st.st_mode);
+    };
+
+    add(path.to_native_path());
+    if (!is_directory) {
+        return m_total - total_before;
+    }
+
+    std::error_code ec;
+    for (std::filesystem::recursive_directory_iterator it(path.to_native_path(), ec), end; !ec && it != end; it.increment(ec)) {
+        add(it->path());
+    }
+    if (ec) {
+        throw std::runtime_error(std::format("m03gagbhsnusi43zogoacgj2ez_filesystem::disk_usage_t::add: failed to traverse '{}': {}", path, ec.message()));
+    }
+
+    return m_total - total_before;
+}
+
+std::uintmax_t disk_usage_t::total() const {
+    return m_total;
+}
+
+std::uint64_t content_hash(const path_t& path) {
+    std::ifstream ifs(path.to_native_path(), std::ios::binary);
+    if (!ifs) {
+        throw std::runtime_error(std::format("m03gagbhsnusi43zogoacgj2ez_filesystem::content_hash: failed to open file '{}'", path));
+    }
+
+    std::uint64_t result = 0xcbf29ce484222325ull;
+    char buffer[1 << 16];
+    while (ifs) {
+        ifs.read(buffer, sizeof(buffer));
+        const auto count = ifs.gcount();
+        for (std::streamsize i = 0; i < count; ++i) {
+            result ^= static_cast<unsigned char>(buffer[i]);
+            result *= 0x100000001b3ull;
+        }
+    }
+    if (ifs.bad()) {
+        throw std::runtime_error(std::format("m03gagbhsnusi43zogoacgj2ez_filesystem::content_hash: failed to read file '{}'", path));
+    }
+
+    return result;
+}
+
+bool same_contents(const path_t& a, const path_t& b) {
+    if (file_size(a) != file_size(b)) {
+        return false;
+    }
+
+    std::ifstream a_ifs(a.to_native_path(), std::ios::binary);
+    if (!a_ifs) {
+        throw std::runtime_error(std::format("m03gagbhsnusi43zogoacgj2ez_filesystem::same_contents: failed to open file '{}'", a));
+    }
+    std::ifstream b_ifs(b.to_native_path(), std::ios::binary);
+    if (!b_ifs) {
+        throw std::runtime_error(std::format("m03gagbhsnusi43zogoacgj2ez_filesystem::same_contents: failed to open file '{}'", b));
+    }
+
+    char a_buffer[1 << 16];
+    char b_buffer[1 << 16];
+    while (a_ifs && b_ifs) {
+        a_ifs.read(a_buffer, sizeof(a_buffer));
+        b_ifs.read(b_buffer, sizeof(b_buffer));
+        const auto count = a_ifs.gcount();
+        if (count != b_ifs.gcount() || std::memcmp(a_buffer, b_buffer, static_cast<std::size_t>(count)) != 0) {
+            return false;
+        }
+    }
+    if (a_ifs.bad() || b_ifs.bad()) {
+        throw std::runtime_error(std::format("m03gagbhsnusi43zogoacgj2ez_filesystem::same_contents: failed to read files '{}' and '{}'", a, b));
+    }
+
+    return a_ifs.eof() && b_ifs.eof();
+}
+
 } // namespace m03gagbhsnusi43zogoacgj2ez_filesystem
@@ -1,9 +1,12 @@
 #ifndef M03GAGBHSNUSI43ZOGOACGJ2EZ_FILESYSTEM_FILESYSTEM_H
 # define M03GAGBHSNUSI43ZOGOACGJ2EZ_FILESYSTEM_FILESYSTEM_H
 
+# include <cstdint>
 # include <filesystem>
 # include <functional>
 # include <format>
+# include <set>
+# include <utility>
 
 /**
  * Checked filesystem paths and operations.
@@ -266,6 +269,20 @@ path_t canonical(const path_t& path);
  */
 void copy(const path_t& src, const path_t& dst);
 
+/**
+ * Makes dst a copy-on-write clone of the regular file src and creates dst parent directories.
+ *
+ * Returns false, leaving dst absent, when the filesystem cannot share extents between src and dst.
+ */
+bool clone_file(const path_t& src, const path_t& dst);
+
+/**
+ * Creates dst as a hard link to the regular file src and creates dst parent directories.
+ *
+ * Returns false, leaving dst absent, when src and dst are on different filesystems or the filesystem has no hard links.
+ */
+bool create_hard_link(const path_t& src, const path_t& dst);
+
 /**
  * Updates path's timestamp or creates an empty file.
  *
@@ -313,6 +330,11 @@ std::uintmax_t file_size(const path_t& path);
  */
 std::filesystem::file_time_type last_write_time(const path_t& path);
 
+/**
+ * Returns the latest last_write_time() of directory and everything under it, without descending into symlinks.
+ */
+std::filesystem::file_time_type latest_write_time(const path_t& directory);
+
 /**
  * Removes a single file or empty directory.
  *
@@ -347,6 +369,64 @@ bool is_regular_file(const path_t& path);
  */
 bool is_directory(const path_t& path);
 
+/**
+ * Returns the number of hard links to the file.
+ */
+std::uintmax_t hard_link_count(const path_t& path);
+
+/**
+ * Returns the permission bits of the file.
+ */
+std::filesystem::perms permissions(const path_t& path);
+
+/**
+ * Replaces the permission bits of the file.
+ */
+void permissions(const path_t& path, std::filesystem::perms permissions);
+
+/**
+ * Checks whether the path itself is a symbolic link.
+ */
+bool is_symlink(const path_t& path);
+
+/**
+ * Returns the path a symbolic link points to, without resolving it further.
+ *
+ * A relative target is resolved against the directory containing the link.
+ */
+path_t read_symlink(const path_t& path);
+
+/**
+ * Bytes allocated on disk under every path added so far.
+ *
+ * Symbolic links are not followed, and a hard-linked file is counted once across all added paths.
+ */
+class disk_usage_t {
+public:
+    /**
+     * Adds the file or directory tree at path and returns the bytes it added to total().
+     */
+    std::uintmax_t add(const path_t& path);
+
+    std::uintmax_t total() const;
+
+private:
+    std::set<std::pair<std::uintmax_t, std::uintmax_t>> m_counted;
+    std::uintmax_t m_total = 0;
+};
+
+/**
+ * Returns the 64-bit FNV-1a hash of a regular file's contents.
+ *
+ * Detects changed artifacts; not collision resistant against crafted input.
+ */
+std::uint64_t content_hash(const path_t& path);
+
+/**
+ * Checks whether two regular files hold the same bytes.
+ */
+bool same_contents(const path_t& a, const path_t& b);
+
 } // namespace m03gagbhsnusi43zogoacgj2ez_filesystem
 
 template <>
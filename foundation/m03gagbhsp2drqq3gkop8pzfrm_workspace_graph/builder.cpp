@@ -1,5 +1,6 @@
 #include <m03gagbhsujjf63n0w3r2w4q6h_build_phases/build_phases.h>
 #include <m03gagbhsnusi43zogoacgj2ez_filesystem/filesystem.h>
+#include <m03gagbhsp2drqq3gkop8pzfrm_workspace_graph/workspace_graph.h>
 
 namespace m03gagbhsp2drqq3gkop8pzfrm_workspace_graph {
 
@@ -20,6 +21,12 @@ extern "C" void phase__library(const m03gagbhsujjf63n0w3r2w4q6h_build_phases::li
     phase->install_library(library);
 }
 
-extern "C" void phase__binary(const m03gagbhsujjf63n0w3r2w4q6h_build_phases::binary_phase_t*) {
+extern "C" void phase__binary(const m03gagbhsujjf63n0w3r2w4q6h_build_phases::binary_phase_t* phase) {
+    const auto sources = phase->install<m03gagbhsujjf63n0w3r2w4q6h_build_phases::source_phase_t>();
+    const auto cli = phase->build_cli(
+        { phase->build(sources.root() / m03gagbhsnusi43zogoacgj2ez_filesystem::relative_path_t(m03gagbhsp2drqq3gkop8pzfrm_workspace_graph::CLI_CPP)) },
+        {}
+    );
+    phase->install_cli(cli);
 }
 } // namespace m03gagbhsp2drqq3gkop8pzfrm_workspace_graph
@@ -0,0 +1,29 @@
+#include <m03gagbhsp2drqq3gkop8pzfrm_workspace_graph/workspace_graph.h>
+
+#include <exception>
+#include <format>
+#include <iostream>
+#include <string_view>
+
+int main(int argc, char** argv) {
+    if (argc != 2 || std::string_view(argv[1]) != "verify") {
+        std::cerr << "usage: " << argv[0] << " verify\n";
+        return 1;
+    }
+
+    try {
+        const auto invocation_context = m03gagbhsp2drqq3gkop8pzfrm_workspace_graph::invocation_context();
+        m03gagbhsp2drqq3gkop8pzfrm_workspace_graph::workspace_graph_t workspace_graph(
+            invocation_context.workspace_root,
+            invocation_context.artifact_root
+        );
+
+        const auto modules = workspace_graph.verify();
+        std::cout << std::format("verified {} modules", modules) << std::endl;
+    } catch (const std::exception& e) {
+        std::cerr << std::format("{}: {}", argv[0], e.what()) << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -4,15 +4,18 @@
 #include <m03gagbhsqfsqblhwvelrou7nc_json/external/json.hpp>
 
 #include <algorithm>
+#include <bit>
 #include <cerrno>
 #include <cstdlib>
 #include <cstring>
 #include <fstream>
 #include <format>
 #include <limits>
-#include <stack>
+#include <memory>
+#include <new>
 #include <stdexcept>
 #include <string>
+#include <unordered_set>
 #include <utility>
 #include <vector>
 
@@ -20,8 +23,11 @@ namespace m03gagbhsp2drqq3gkop8pzfrm_workspace_graph {
 
 static constexpr const char* WORKSPACE_ROOT_ENV = "BUILDER_WORKSPACE_ROOT";
 static constexpr const char* ARTIFACT_ROOT_ENV = "BUILDER_ARTIFACT_ROOT";
+static constexpr const char* SCRATCH_ROOT_ENV = "BUILDER_SCRATCH_ROOT";
 static constexpr const char* BOOTSTRAP_SEED_MODULE = "m03gagbhst621faiop1rztfkqp_builder_cli";
 static constexpr const char* BOOTSTRAP_SEED_WORKSPACE = "foundation";
+static constexpr uint32_t UNINDEXED_MODULE = std::numeric_limits<uint32_t>::max();
+static constexpr uint32_t UNASSIGNED_COMPONENT = std::numeric_limits<uint32_t>::max();
 
 struct json_workspace_order_manifest_t {
     std::vector<std::string> workspaces;
@@ -40,52 +46,218 @@ struct module_info_t {
     bool on_stack;
 };
 
+struct strong_connect_frame_t {
+    module_t* module;
+    uint32_t position;
+};
+
+class module_scc_t;
+
+struct closure_frame_t {
+    module_scc_t* scc;
+    std::size_t position;
+};
+
 class module_scc_t {
 public:
     void add_module(module_t& module);
     void add_dependency(module_scc_t& dependency);
     const std::vector<module_t*>& modules() const;
     const std::vector<module_scc_t*>& dependencies() const;
+    module_t::groups_t closure_groups();
 
 private:
     std::vector<module_t*> m_modules;
     std::vector<module_scc_t*> m_dependencies;
+
+    // Discovery only appends components whose dependencies already exist, so a computed closure never goes stale.
+    std::vector<module_t::group_t> m_closure_groups;
+};
+
+/**
+ * Compressed sparse row adjacency: edges of module i are targets[offsets[i], offsets[i + 1]).
+ */
+struct module_adjacency_t {
+    std::vector<uint32_t> offsets;
+    std::vector<module_t*> targets;
+};
+
+/**
+ * Compressed sparse row adjacency between reachability components.
+ */
+struct component_adjacency_t {
+    std::vector<uint32_t> offsets;
+    std::vector<uint32_t> targets;
+};
+
+/**
+ * One bit per component id.
+ */
+using component_bitset_t = std::vector<uint64_t>;
+
+/**
+ * Typed arena with stable addresses.
+ *
+ * clear() destroys objects in reverse construction order and keeps the chunks for reuse.
+ */
+template <class T>
+class arena_t {
+public:
+    arena_t() = default;
+    arena_t(const arena_t&) = delete;
+    arena_t& operator=(const arena_t&) = delete;
+
+    ~arena_t() {
+        clear();
+        for (auto* chunk : m_chunks) {
+            ::operator delete(chunk, std::align_val_t(alignof(T)));
+        }
+    }
+
+    template <class... args_t>
+    T& make(args_t&&... args) {
+        if (m_size == m_chunks.size() * CHUNK_SIZE) {
+            m_chunks.push_back(static_cast<T*>(::operator new(sizeof(T) * CHUNK_SIZE, std::align_val_t(alignof(T)))));
+        }
+
+        auto* result = new (m_chunks[m_size / CHUNK_SIZE] + m_size % CHUNK_SIZE) T(std::forward<args_t>(args)...);
+        ++m_size;
+
+        return *result;
+    }
+
+    void clear() {
+        while (0 < m_size) {
+            --m_size;
+            (m_chunks[m_size / CHUNK_SIZE] + m_size % CHUNK_SIZE)->~T();
+        }
+    }
+
+private:
+    static constexpr std::size_t CHUNK_SIZE = 256;
+
+    std::vector<T*> m_chunks;
+    std::size_t m_size = 0;
+};
+
+/**
+ * Interned module name: the workspace listing it and, once discovered, its module.
+ */
+struct module_name_entry_t {
+    workspace_t* workspace;
+    module_t* module;
 };
 
 class workspace_graph_storage_t {
 public:
-    void clear_sccs();
+    workspace_t& make_workspace(workspace_graph_t& workspace_graph, const m03gagbhsnusi43zogoacgj2ez_filesystem::relative_path_t& relative_path, uint32_t order_position);
+    module_t& make_module(workspace_t& workspace, const module_name_t& name, version_t version);
+    module_scc_t& make_scc();
+    void clear();
+
+    const std::vector<workspace_t*>& workspaces() const;
+    module_name_entry_t* find_module_name(const module_name_t& name);
+    module_name_entry_t& add_module_name(const module_name_t& name, workspace_t& workspace);
+
+    void add_module(module_t& module);
+    std::vector<module_t*> freeze();
+    const std::vector<module_t*>& modules() const;
+    uint32_t index(const module_t& module) const;
+    std::span<module_t* const> dependencies(const module_t& module) const;
+    std::span<module_t* const> builder_dependencies(const module_t& module) const;
+
     void scc(module_t& module, module_scc_t& scc);
     module_scc_t& scc(const module_t& module) const;
 
+    void add_component(std::span<module_t* const> modules);
+    uint32_t component(const module_t& module) const;
+    std::span<module_t* const> component_modules(uint32_t component) const;
+    const component_bitset_t& reachable_components(uint32_t component);
+    const component_bitset_t& dependent_components(uint32_t component);
+
 private:
-    std::unordered_map<const module_t*, module_scc_t*> m_scc_by_module;
+    // Destroyed in reverse member order: SCCs and modules before the workspaces they point into.
+    arena_t<workspace_t> m_workspace_arena;
+    arena_t<module_t> m_module_arena;
+    arena_t<module_scc_t> m_scc_arena;
+    std::vector<workspace_t*> m_workspaces;
+
+    std::unordered_map<module_name_t, uint32_t, module_name_hash_t> m_module_name_ids;
+    std::vector<module_name_entry_t> m_module_names;
+
+    std::vector<module_t*> m_unindexed_modules;
+    std::vector<module_t*> m_modules;
+    module_adjacency_t m_dependencies;
+    module_adjacency_t m_builder_dependencies;
+    std::vector<module_scc_t*> m_scc_by_index;
+
+    // Strongly connected components over module and builder edges, ids in dependency-to-dependent order.
+    std::vector<uint32_t> m_component_by_index;
+    module_adjacency_t m_component_modules;
+    component_adjacency_t m_component_dependencies;
+    std::vector<component_bitset_t> m_reachable_components;
+
+    // Rebuilt on the first reverse query after discovery adds components.
+    component_adjacency_t m_component_dependents;
+    std::vector<component_bitset_t> m_dependent_components;
 };
 
+static bool module_less(const module_t* lhs, const module_t* rhs);
+
+static bool component_bitset_test(const component_bitset_t& bitset, uint32_t component) {
+    return component / 64 < bitset.size() && (bitset[component / 64] >> (component % 64) & 1) != 0;
+}
+
+static void component_bitset_set(component_bitset_t& bitset, uint32_t component) {
+    bitset[component / 64] |= uint64_t(1) << (component % 64);
+}
+
 static void path_env(const char* name, const m03gagbhsnusi43zogoacgj2ez_filesystem::path_t& path) {
     if (setenv(name, path.c_str(), 1) == -1) {
         throw std::runtime_error(std::format("m03gagbhsp2drqq3gkop8pzfrm_workspace_graph: failed to set {}: {}", name, std::strerror(errno)));
     }
 }
 
-module_name_t::module_name_t(std::string_view name):
-    m_name(name)
-{
-    if (m_name.empty()) {
+struct module_name_t::interned_t {
+    std::string name;
+    std::size_t hash;
+};
+
+module_name_t::module_name_t(std::string_view name) {
+    if (name.empty()) {
         throw std::runtime_error("m03gagbhsp2drqq3gkop8pzfrm_workspace_graph::module_name_t: module name must not be empty");
     }
+
+    // Keyed by a view of each interned string. Never shrinks: names are few, and graphs rebuilt by clear()
+    // intern the same ones again.
+    static std::unordered_map<std::string_view, std::unique_ptr<const interned_t>> interned_names;
+    if (const auto it = interned_names.find(name); it != interned_names.end()) {
+        m_interned = it->second.get();
+        return ;
+    }
+
+    auto interned = std::make_unique<const interned_t>(interned_t {
+        .name = std::string(name),
+        .hash = std::hash<std::string_view>()(name)
+    });
+    m_interned = interned.get();
+    interned_names.emplace(m_interned->name, std::move(interned));
 }
 
 const std::string& module_name_t::string() const {
-    return m_name;
+    return m_interned->name;
 }
 
 const char* module_name_t::c_str() const {
-    return m_name.c_str();
+    return m_interned->name.c_str();
+}
+
+std::size_t module_name_t::hash() const {
+    return m_interned->hash;
 }
 
 bool module_name_t::operator==(const module_name_t& other) const {
-    return m_name == other.m_name;
+    return m_interned == other.m_interned;
 }
 
 static m03gagbhsnusi43zogoacgj2ez_filesystem::path_t workspace_root() {
@@ -114,28 +286,87 @@ static m03gagbhsnusi43zogoacgj2ez_filesystem::path_t artifact_root(const m03gagb
     return m03gagbhsnusi43zogoacgj2ez_filesystem::path_t(artifact_root_env);
 }
 
+static m03gagbhsnusi43zogoacgj2ez_filesystem::path_t scratch_root(const m03gagbhsnusi43zogoacgj2ez_filesystem::path_t& artifact_root) {
+    const char* scratch_root_env = std::getenv(SCRATCH_ROOT_ENV);
+    if (scratch_root_env == nullptr) {
+        return artifact_root;
+    }
+
+    if (*scratch_root_env == '\0') {
+        throw std::runtime_error(std::format("m03gagbhsp2drqq3gkop8pzfrm_workspace_graph::invocation_context: {} must not be empty", SCRATCH_ROOT_ENV));
+    }
+
+    return m03gagbhsnusi43zogoacgj2ez_filesystem::path_t(scratch_root_env);
+}
+
 invocation_context_t invocation_context() {
     const auto root = workspace_root();
+    const auto artifacts = artifact_root(root);
     const auto context = invocation_context_t {
         .workspace_root = root,
-        .artifact_root = artifact_root(root)
+        .artifact_root = artifacts,
+        .scratch_root = scratch_root(artifacts)
     };
 
     path_env(WORKSPACE_ROOT_ENV, context.workspace_root);
     path_env(ARTIFACT_ROOT_ENV, context.artifact_root);
+    // Left unset by default so a child that moves BUILDER_ARTIFACT_ROOT also moves its scratch.
+    if (std::getenv(SCRATCH_ROOT_ENV) != nullptr) {
+        path_env(SCRATCH_ROOT_ENV, context.scratch_root);
+    }
 
     return context;
 }
 
-workspace_graph_t::workspace_graph_t(m03gagbhsnusi43zogoacgj2ez_filesystem::path_t workspace_root, m03gagbhsnusi43zogoacgj2ez_filesystem::path_t artifact_dir):
+workspace_graph_t::workspace_graph_t(
+    m03gagbhsnusi43zogoacgj2ez_filesystem::path_t workspace_root,
+    m03gagbhsnusi43zogoacgj2ez_filesystem::path_t artifact_dir,
+    std::optional<m03gagbhsnusi43zogoacgj2ez_filesystem::path_t> scratch_dir
+):
     m_root(std::move(workspace_root)),
-    m_artifact_root(std::move(artifact_dir)),
+    m_artifact_root(artifact_dir),
+    m_scratch_root(scratch_dir ? std::move(*scratch_dir) : std::move(artifact_dir)),
     m_bootstrap_seed_workspace(nullptr),
     m_bootstrap_seed_module(nullptr),
     m_storage(new workspace_graph_storage_t)
 {
 }
 
+workspace_graph_t::~workspace_graph_t() {
+    delete m_storage;
+}
+
+void workspace_graph_t::clear() {
+    m_workspace_by_relative_path.clear();
+    m_bootstrap_seed_workspace = nullptr;
+    m_bootstrap_seed_module = nullptr;
+    m_workspaces_json_version.reset();
+    m_storage->clear();
+}
+
+bool workspace_graph_t::is_stale() const {
+    if (!m_workspaces_json_version) {
+        return false;
+    }
+
+    const auto workspaces_json_file = root() / m03gagbhsnusi43zogoacgj2ez_filesystem::relative_path_t(WORKSPACES_JSON);
+    if (
+        !m03gagbhsnusi43zogoacgj2ez_filesystem::exists(workspaces_json_file) ||
+        version_t(m03gagbhsnusi43zogoacgj2ez_filesystem::last_write_time(workspaces_json_file)).value != m_workspaces_json_version->value
+    ) {
+        return true;
+    }
+
+    for (const auto* module : m_storage->modules()) {
+        const auto source_dir = module->source_dir();
+        if (!m03gagbhsnusi43zogoacgj2ez_filesystem::exists(source_dir) || version_t(source_dir).value != module->source_version().value) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
 const m03gagbhsnusi43zogoacgj2ez_filesystem::path_t& workspace_graph_t::root() const {
     return m_root;
 }
@@ -144,6 +375,10 @@ const m03gagbhsnusi43zogoacgj2ez_filesystem::path_t& workspace_graph_t::artifact
     return m_artifact_root;
 }
 
+const m03gagbhsnusi43zogoacgj2ez_filesystem::path_t& workspace_graph_t::scratch_root() const {
+    return m_scratch_root;
+}
+
 module_t& workspace_graph_t::bootstrap_seed_module() const {
     if (m_bootstrap_seed_module == nullptr) {
         throw std::runtime_error("m03gagbhsp2drqq3gkop8pzfrm_workspace_graph::workspace_graph_t::bootstrap_seed_module: bootstrap seed module has not been discovered");
@@ -163,30 +398,32 @@ bool workspace_graph_t::is_active_builder_bootstrap_module(const module_t& modul
         return false;
     }
 
-    std::vector<const module_t*> pending { m_bootstrap_seed_module };
-    std::unordered_set<const module_t*> visited;
-
-    while (!pending.empty()) {
-        const auto* current = pending.back();
-        pending.pop_back();
+    return reaches(*m_bootstrap_seed_module, module);
+}
 
-        if (!visited.insert(current).second) {
-            continue ;
-        }
+bool workspace_graph_t::reaches(const module_t& module, const module_t& dependency) const {
+    const auto& reachable_components = m_storage->reachable_components(m_storage->component(module));
+    return component_bitset_test(reachable_components, m_storage->component(dependency));
+}
 
-        if (current == &module) {
-            return true;
-        }
+std::vector<const module_t*> workspace_graph_t::dependents(const module_t& module) const {
+    const auto& dependent_components = m_storage->dependent_components(m_storage->component(module));
 
-        for (const auto* dependency : current->dependencies()) {
-            pending.push_back(dependency);
-        }
-        for (const auto* dependency : current->builder_dependencies()) {
-            pending.push_back(dependency);
+    std::vector<const module_t*> result;
+    for (uint32_t word = 0; word < dependent_components.size(); ++word) {
+        for (auto bits = dependent_components[word]; bits != 0; bits &= bits - 1) {
+            const auto component = word * 64 + static_cast<uint32_t>(std::countr_zero(bits));
+            for (const auto* dependent : m_storage->component_modules(component)) {
+                if (dependent != &module) {
+                    result.push_back(dependent);
+                }
+            }
         }
     }
 
-    return false;
+    std::sort(result.begin(), result.end(), module_less);
+
+    return result;
 }
 
 workspace_t::workspace_t(workspace_graph_t& workspace_graph, m03gagbhsnusi43zogoacgj2ez_filesystem::relative_path_t relative_path, uint32_t order_position):
@@ -211,7 +448,9 @@ uint32_t workspace_t::order_position() const {
 module_t::module_t(workspace_t& workspace, module_name_t name, version_t version):
     m_workspace(&workspace),
     m_version(version),
-    m_name(std::move(name))
+    m_source_version(version),
+    m_name(std::move(name)),
+    m_index(UNINDEXED_MODULE)
 {
 }
 
@@ -227,12 +466,24 @@ void module_t::version(version_t version) {
     m_version = version;
 }
 
+version_t module_t::source_version() const {
+    return m_source_version;
+}
+
 void module_t::add_dependency(module_t& dependency) {
-    m_dependencies.insert(&dependency);
+    m_declared_dependencies.push_back(&dependency);
 }
 
 void module_t::add_builder_dependency(module_t& dependency) {
-    m_builder_dependencies.insert(&dependency);
+    m_declared_builder_dependencies.push_back(&dependency);
+}
+
+uint32_t module_t::index() const {
+    if (m_index == UNINDEXED_MODULE) {
+        throw std::runtime_error(std::format("m03gagbhsp2drqq3gkop8pzfrm_workspace_graph::module_t::index: module '{}' has not been indexed by discovery", m_name));
+    }
+
+    return m_index;
 }
 
 void module_scc_t::add_module(module_t& module) {
@@ -251,51 +502,307 @@ const std::vector<module_scc_t*>& module_scc_t::dependencies() const {
     return m_dependencies;
 }
 
-void workspace_graph_storage_t::clear_sccs() {
-    m_scc_by_module.clear();
+module_t::groups_t module_scc_t::closure_groups() {
+    if (!m_closure_groups.empty()) {
+        return m_closure_groups;
+    }
+
+    std::unordered_set<const module_scc_t*> visited_sccs { this };
+    std::vector<closure_frame_t> frames { closure_frame_t { .scc = this, .position = 0 } };
+    while (!frames.empty()) {
+        auto& frame = frames.back();
+        if (frame.position < frame.scc->m_dependencies.size()) {
+            auto* dependency = frame.scc->m_dependencies[frame.position++];
+            if (visited_sccs.insert(dependency).second) {
+                frames.push_back(closure_frame_t { .scc = dependency, .position = 0 });
+            }
+            continue ;
+        }
+
+        m_closure_groups.push_back(module_t::group_t(frame.scc->m_modules));
+        frames.pop_back();
+    }
+
+    return m_closure_groups;
+}
+
+static void append_adjacency(module_adjacency_t& adjacency, const std::vector<module_t*>& modules, std::vector<module_t*> module_t::* declared_edges) {
+    if (adjacency.offsets.empty()) {
+        adjacency.offsets.push_back(0);
+    }
+
+    for (auto* module : modules) {
+        const auto begin = adjacency.targets.size();
+        adjacency.targets.insert(adjacency.targets.end(), (module->*declared_edges).begin(), (module->*declared_edges).end());
+
+        std::sort(adjacency.targets.begin() + begin, adjacency.targets.end(), module_less);
+        adjacency.targets.erase(std::unique(adjacency.targets.begin() + begin, adjacency.targets.end()), adjacency.targets.end());
+
+        adjacency.offsets.push_back(static_cast<uint32_t>(adjacency.targets.size()));
+    }
+}
+
+workspace_t& workspace_graph_storage_t::make_workspace(workspace_graph_t& workspace_graph, const m03gagbhsnusi43zogoacgj2ez_filesystem::relative_path_t& relative_path, uint32_t order_position) {
+    auto& workspace = m_workspace_arena.make(workspace_graph, relative_path, order_position);
+    m_workspaces.push_back(&workspace);
+
+    return workspace;
+}
+
+module_t& workspace_graph_storage_t::make_module(workspace_t& workspace, const module_name_t& name, version_t version) {
+    return m_module_arena.make(workspace, name, version);
+}
+
+module_scc_t& workspace_graph_storage_t::make_scc() {
+    return m_scc_arena.make();
+}
+
+void workspace_graph_storage_t::clear() {
+    m_scc_arena.clear();
+    m_module_arena.clear();
+    m_workspace_arena.clear();
+    m_workspaces.clear();
+
+    m_module_name_ids.clear();
+    m_module_names.clear();
+
+    m_unindexed_modules.clear();
+    m_modules.clear();
+    m_dependencies = module_adjacency_t();
+    m_builder_dependencies = module_adjacency_t();
+    m_scc_by_index.clear();
+
+    m_component_by_index.clear();
+    m_component_modules = module_adjacency_t();
+    m_component_dependencies = component_adjacency_t();
+    m_reachable_components.clear();
+    m_component_dependents = component_adjacency_t();
+    m_dependent_components.clear();
+}
+
+const std::vector<workspace_t*>& workspace_graph_storage_t::workspaces() const {
+    return m_workspaces;
+}
+
+module_name_entry_t* workspace_graph_storage_t::find_module_name(const module_name_t& name) {
+    const auto it = m_module_name_ids.find(name);
+    if (it == m_module_name_ids.end()) {
+        return nullptr;
+    }
+
+    return &m_module_names[it->second];
+}
+
+module_name_entry_t& workspace_graph_storage_t::add_module_name(const module_name_t& name, workspace_t& workspace) {
+    m_module_name_ids.emplace(name, static_cast<uint32_t>(m_module_names.size()));
+    m_module_names.push_back(module_name_entry_t {
+        .workspace = &workspace,
+        .module = nullptr
+    });
+
+    return m_module_names.back();
+}
+
+void workspace_graph_storage_t::add_module(module_t& module) {
+    m_unindexed_modules.push_back(&module);
+}
+
+std::vector<module_t*> workspace_graph_storage_t::freeze() {
+    auto modules = std::move(m_unindexed_modules);
+    m_unindexed_modules.clear();
+
+    if (std::numeric_limits<uint32_t>::max() - m_modules.size() <= modules.size()) {
+        throw std::runtime_error(std::format("m03gagbhsp2drqq3gkop8pzfrm_workspace_graph::workspace_graph_storage_t::freeze: too many modules: {}", m_modules.size() + modules.size()));
+    }
+
+    // Indices are append-only: edges of already indexed modules never change, so their adjacency and SCCs stay valid.
+    std::sort(modules.begin(), modules.end(), module_less);
+    for (auto* module : modules) {
+        module->m_index = static_cast<uint32_t>(m_modules.size());
+        m_modules.push_back(module);
+    }
+
+    append_adjacency(m_dependencies, modules, &module_t::m_declared_dependencies);
+    append_adjacency(m_builder_dependencies, modules, &module_t::m_declared_builder_dependencies);
+    m_scc_by_index.resize(m_modules.size(), nullptr);
+    m_component_by_index.resize(m_modules.size(), UNASSIGNED_COMPONENT);
+
+    return modules;
+}
+
+const std::vector<module_t*>& workspace_graph_storage_t::modules() const {
+    return m_modules;
+}
+
+uint32_t workspace_graph_storage_t::index(const module_t& module) const {
+    const auto index = module.m_index;
+    if (m_modules.size() <= index || m_modules[index] != &module) {
+        throw std::runtime_error(std::format("m03gagbhsp2drqq3gkop8pzfrm_workspace_graph::workspace_graph_storage_t::index: module '{}' has not been indexed by discovery", module.name()));
+    }
+
+    return index;
+}
+
+std::span<module_t* const> workspace_graph_storage_t::dependencies(const module_t& module) const {
+    const auto i = index(module);
+    return std::span<module_t* const>(m_dependencies.targets.data() + m_dependencies.offsets[i], m_dependencies.offsets[i + 1] - m_dependencies.offsets[i]);
+}
+
+std::span<module_t* const> workspace_graph_storage_t::builder_dependencies(const module_t& module) const {
+    const auto i = index(module);
+    return std::span<module_t* const>(m_builder_dependencies.targets.data() + m_builder_dependencies.offsets[i], m_builder_dependencies.offsets[i + 1] - m_builder_dependencies.offsets[i]);
 }
 
 void workspace_graph_storage_t::scc(module_t& module, module_scc_t& scc) {
-    m_scc_by_module[&module] = &scc;
+    m_scc_by_index[index(module)] = &scc;
 }
 
 module_scc_t& workspace_graph_storage_t::scc(const module_t& module) const {
-    const auto it = m_scc_by_module.find(&module);
-    if (it == m_scc_by_module.end()) {
+    auto* result = m_scc_by_index[index(module)];
+    if (result == nullptr) {
         throw std::runtime_error(std::format("m03gagbhsp2drqq3gkop8pzfrm_workspace_graph::workspace_graph_storage_t::scc: module '{}' has no SCC", module.name()));
     }
 
-    return *it->second;
+    return *result;
 }
 
-module_t::groups_t module_t::closure_groups() const {
-    return workspace().graph().closure_groups(*this);
+void workspace_graph_storage_t::add_component(std::span<module_t* const> modules) {
+    const auto component = static_cast<uint32_t>(m_reachable_components.size());
+    if (m_component_modules.offsets.empty()) {
+        m_component_modules.offsets.push_back(0);
+        m_component_dependencies.offsets.push_back(0);
+    }
+
+    for (auto* module : modules) {
+        m_component_by_index[index(*module)] = component;
+        m_component_modules.targets.push_back(module);
+    }
+    m_component_modules.offsets.push_back(static_cast<uint32_t>(m_component_modules.targets.size()));
+
+    const auto begin = m_component_dependencies.targets.size();
+    for (auto* module : modules) {
+        for (auto* dependency : dependencies(*module)) {
+            if (const auto dependency_component = this->component(*dependency); dependency_component != component) {
+                m_component_dependencies.targets.push_back(dependency_component);
+            }
+        }
+        for (auto* builder_dependency : builder_dependencies(*module)) {
+            if (const auto dependency_component = this->component(*builder_dependency); dependency_component != component) {
+                m_component_dependencies.targets.push_back(dependency_component);
+            }
+        }
+    }
+    std::sort(m_component_dependencies.targets.begin() + begin, m_component_dependencies.targets.end());
+    m_component_dependencies.targets.erase(std::unique(m_component_dependencies.targets.begin() + begin, m_component_dependencies.targets.end()), m_component_dependencies.targets.end());
+    m_component_dependencies.offsets.push_back(static_cast<uint32_t>(m_component_dependencies.targets.size()));
+
+    m_reachable_components.emplace_back();
 }
 
-module_t::groups_t workspace_graph_t::closure_groups(const module_t& module) const {
-    std::unordered_set<const module_scc_t*> visited_sccs;
-    module_t::groups_t result;
+uint32_t workspace_graph_storage_t::component(const module_t& module) const {
+    const auto result = m_component_by_index[index(module)];
+    if (result == UNASSIGNED_COMPONENT) {
+        throw std::runtime_error(std::format("m03gagbhsp2drqq3gkop8pzfrm_workspace_graph::workspace_graph_storage_t::component: module '{}' has no reachability component", module.name()));
+    }
 
-    const auto collect_scc = [&]<class self_t>(self_t& self, const module_scc_t& current_scc) -> void {
-        if (!visited_sccs.insert(&current_scc).second) {
-            return ;
+    return result;
+}
+
+std::span<module_t* const> workspace_graph_storage_t::component_modules(uint32_t component) const {
+    return std::span<module_t* const>(m_component_modules.targets.data() + m_component_modules.offsets[component], m_component_modules.offsets[component + 1] - m_component_modules.offsets[component]);
+}
+
+const component_bitset_t& workspace_graph_storage_t::reachable_components(uint32_t component) {
+    if (!m_reachable_components[component].empty()) {
+        return m_reachable_components[component];
+    }
+
+    // Dependencies always have smaller ids, so component + 1 bits cover the closure.
+    component_bitset_t result(component / 64 + 1, 0);
+    component_bitset_set(result, component);
+
+    std::vector<uint32_t> pending { component };
+    while (!pending.empty()) {
+        const auto current = pending.back();
+        pending.pop_back();
+
+        for (auto i = m_component_dependencies.offsets[current]; i < m_component_dependencies.offsets[current + 1]; ++i) {
+            const auto dependency = m_component_dependencies.targets[i];
+            if (component_bitset_test(result, dependency)) {
+                continue ;
+            }
+
+            if (const auto& memoized = m_reachable_components[dependency]; !memoized.empty()) {
+                for (std::size_t word = 0; word < memoized.size(); ++word) {
+                    result[word] |= memoized[word];
+                }
+                continue ;
+            }
+
+            component_bitset_set(result, dependency);
+            pending.push_back(dependency);
+        }
+    }
+
+    m_reachable_components[component] = std::move(result);
+
+    return m_reachable_components[component];
+}
+
+const component_bitset_t& workspace_graph_storage_t::dependent_components(uint32_t component) {
+    const auto component_count = static_cast<uint32_t>(m_reachable_components.size());
+    if (m_dependent_components.size() != component_count) {
+        m_component_dependents.offsets.assign(component_count + 1, 0);
+        for (const auto dependency : m_component_dependencies.targets) {
+            ++m_component_dependents.offsets[dependency + 1];
+        }
+        for (uint32_t i = 0; i < component_count; ++i) {
+            m_component_dependents.offsets[i + 1] += m_component_dependents.offsets[i];
         }
 
-        for (const auto* dependency : current_scc.dependencies()) {
-            self(self, *dependency);
+        m_component_dependents.targets.resize(m_component_dependencies.targets.size());
+        auto positions = m_component_dependents.offsets;
+        for (uint32_t dependent = 0; dependent < component_count; ++dependent) {
+            for (auto i = m_component_dependencies.offsets[dependent]; i < m_component_dependencies.offsets[dependent + 1]; ++i) {
+                m_component_dependents.targets[positions[m_component_dependencies.targets[i]]++] = dependent;
+            }
         }
 
-        module_t::group_t group;
-        group.reserve(current_scc.modules().size());
-        for (auto* module : current_scc.modules()) {
-            group.push_back(module);
+        m_dependent_components.assign(component_count, component_bitset_t());
+    }
+
+    if (!m_dependent_components[component].empty()) {
+        return m_dependent_components[component];
+    }
+
+    component_bitset_t result((component_count + 63) / 64, 0);
+    component_bitset_set(result, component);
+
+    std::vector<uint32_t> pending { component };
+    while (!pending.empty()) {
+        const auto current = pending.back();
+        pending.pop_back();
+
+        for (auto i = m_component_dependents.offsets[current]; i < m_component_dependents.offsets[current + 1]; ++i) {
+            const auto dependent = m_component_dependents.targets[i];
+            if (!component_bitset_test(result, dependent)) {
+                component_bitset_set(result, dependent);
+                pending.push_back(dependent);
+            }
         }
-        result.push_back(std::move(group));
-    };
+    }
 
-    collect_scc(collect_scc, m_storage->scc(module));
+    m_dependent_components[component] = std::move(result);
 
-    return result;
+    return m_dependent_components[component];
+}
+
+module_t::groups_t module_t::closure_groups() const {
+    return workspace().graph().closure_groups(*this);
+}
+
+module_t::groups_t workspace_graph_t::closure_groups(const module_t& module) const {
+    return m_storage->scc(module).closure_groups();
 }
 
 void workspace_graph_t::load_module_index() {
@@ -309,6 +816,9 @@ void workspace_graph_t::load_module_index() {
         throw std::runtime_error(std::format("m03gagbhsp2drqq3gkop8pzfrm_workspace_graph::workspace_graph_t::load_module_index: file does not exist: '{}'", workspaces_json_file));
     }
 
+    // Taken before reading, so an edit while reading is seen by is_stale().
+    const auto workspaces_json_version = version_t(m03gagbhsnusi43zogoacgj2ez_filesystem::last_write_time(workspaces_json_file));
+
     std::ifstream ifs(workspaces_json_file.string());
     if (!ifs) {
         throw std::runtime_error(std::format("m03gagbhsp2drqq3gkop8pzfrm_workspace_graph::workspace_graph_t::load_module_index: failed to open file '{}'", workspaces_json_file));
@@ -329,12 +839,20 @@ void workspace_graph_t::load_module_index() {
             throw std::runtime_error(std::format("m03gagbhsp2drqq3gkop8pzfrm_workspace_graph::workspace_graph_t::load_module_index: duplicate workspace '{}' in '{}'", workspace_relative_path, workspaces_json_file));
         }
 
-        auto workspace = new workspace_t(*this, workspace_relative_path, static_cast<uint32_t>(i));
+        auto& workspace = m_storage->make_workspace(*this, workspace_relative_path, static_cast<uint32_t>(i));
 
-        m_workspace_by_relative_path.emplace(workspace_relative_path, workspace);
+        m_workspace_by_relative_path.emplace(workspace_relative_path, &workspace);
     }
 
-    for (const auto* workspace : workspaces()) {
+    m_workspaces_json_version = workspaces_json_version;
+}
+
+std::vector<module_name_t> workspace_graph_t::scan_module_names() {
+    load_module_index();
+
+    std::vector<module_name_t> result;
+    std::unordered_map<module_name_t, const workspace_t*, module_name_hash_t> workspace_by_module_name;
+    for (const auto* workspace : m_storage->workspaces()) {
         const auto workspace_dir = root() / workspace->relative_path();
         if (!m03gagbhsnusi43zogoacgj2ez_filesystem::exists(workspace_dir)) {
             continue ;
@@ -347,27 +865,28 @@ void workspace_graph_t::load_module_index() {
                 continue ;
             }
 
-            const auto [it, inserted] = m_workspace_by_module_name.emplace(module_name, workspace);
+            const auto [it, inserted] = workspace_by_module_name.emplace(module_name, workspace);
             if (!inserted) {
                 throw std::runtime_error(std::format(
-                    "m03gagbhsp2drqq3gkop8pzfrm_workspace_graph::workspace_graph_t::load_module_index: duplicate module name '{}' found in workspaces '{}' and '{}'; module names are globally unique",
+                    "m03gagbhsp2drqq3gkop8pzfrm_workspace_graph::workspace_graph_t::scan_module_names: duplicate module name '{}' found in workspaces '{}' and '{}'; module names are globally unique",
                     module_name,
                     it->second->relative_path(),
                     workspace->relative_path()
                 ));
             }
+            result.push_back(module_name);
         }
     }
-}
 
-static std::filesystem::file_time_type latest_write_time(const m03gagbhsnusi43zogoacgj2ez_filesystem::path_t& directory) {
-    auto latest_module_file = m03gagbhsnusi43zogoacgj2ez_filesystem::last_write_time(directory);
+    return result;
+}
 
-    for (const auto& path : m03gagbhsnusi43zogoacgj2ez_filesystem::find(directory, m03gagbhsnusi43zogoacgj2ez_filesystem::find_include_predicate_t::include_all, m03gagbhsnusi43zogoacgj2ez_filesystem::find_descend_predicate_t::descend_all)) {
-        latest_module_file = std::max(latest_module_file, m03gagbhsnusi43zogoacgj2ez_filesystem::last_write_time(path.path()));
-    }
+std::size_t workspace_graph_t::verify() {
+    return scan_module_names().size();
+}
 
-    return latest_module_file;
+void workspace_graph_t::discover_all_modules() {
+    discover_modules(scan_module_names());
 }
 
 version_t::version_t(uint64_t value):
@@ -381,7 +900,7 @@ version_t::version_t(const std::filesystem::file_time_type& file_time_type):
 }
 
 version_t::version_t(const m03gagbhsnusi43zogoacgj2ez_filesystem::path_t& directory):
-    version_t(latest_write_time(directory))
+    version_t(m03gagbhsnusi43zogoacgj2ez_filesystem::latest_write_time(directory))
 {
 }
 
@@ -406,6 +925,11 @@ m03gagbhsnusi43zogoacgj2ez_filesystem::path_t module_t::artifact_latest_dir() co
     return artifact_base_dir() / m03gagbhsnusi43zogoacgj2ez_filesystem::relative_path_t("latest");
 }
 
+m03gagbhsnusi43zogoacgj2ez_filesystem::path_t module_t::artifact_scratch_dir() const {
+    const auto versioned_dir_name = std::format("{}@{}", m_name, version().value);
+    return m_workspace->graph().scratch_root() / m03gagbhsnusi43zogoacgj2ez_filesystem::relative_path_t(m_name.string()) / m03gagbhsnusi43zogoacgj2ez_filesystem::relative_path_t(versioned_dir_name);
+}
+
 module_t* workspace_t::find_module(const module_name_t& module_name) const {
     auto it = m_module_by_name.find(module_name);
     if (it == m_module_by_name.end()) {
@@ -440,56 +964,30 @@ std::vector<module_t*> workspace_t::modules() const {
     return result;
 }
 
-std::vector<module_t*> module_t::dependencies() {
-    std::vector<module_t*> result;
-    result.reserve(m_dependencies.size());
-
-    for (auto* dependency : m_dependencies) {
-        result.push_back(dependency);
-    }
-
-    std::sort(result.begin(), result.end(), module_less);
-
-    return result;
+std::span<module_t* const> module_t::dependencies() {
+    return workspace().graph().dependencies(*this);
 }
 
-std::vector<const module_t*> module_t::dependencies() const {
-    std::vector<const module_t*> result;
-    result.reserve(m_dependencies.size());
-
-    for (const auto* dependency : m_dependencies) {
-        result.push_back(dependency);
-    }
-
-    std::sort(result.begin(), result.end(), module_less);
-
-    return result;
+std::span<const module_t* const> module_t::dependencies() const {
+    const auto result = workspace().graph().dependencies(*this);
+    return std::span<const module_t* const>(result.data(), result.size());
 }
 
-std::vector<module_t*> module_t::builder_dependencies() {
-    std::vector<module_t*> result;
-    result.reserve(m_builder_dependencies.size());
-
-    for (auto* dependency : m_builder_dependencies) {
-        result.push_back(dependency);
-    }
-
-    std::sort(result.begin(), result.end(), module_less);
-
-    return result;
+std::span<module_t* const> module_t::builder_dependencies() {
+    return workspace().graph().builder_dependencies(*this);
 }
 
-std::vector<const module_t*> module_t::builder_dependencies() const {
-    std::vector<const module_t*> result;
-    result.reserve(m_builder_dependencies.size());
-
-    for (const auto* dependency : m_builder_dependencies) {
-        result.push_back(dependency);
-    }
+std::span<const module_t* const> module_t::builder_dependencies() const {
+    const auto result = workspace().graph().builder_dependencies(*this);
+    return std::span<const module_t* const>(result.data(), result.size());
+}
 
-    std::sort(result.begin(), result.end(), module_less);
+std::span<module_t* const> workspace_graph_t::dependencies(const module_t& module) const {
+    return m_storage->dependencies(module);
+}
 
-    return result;
+std::span<module_t* const> workspace_graph_t::builder_dependencies(const module_t& module) const {
+    return m_storage->builder_dependencies(module);
 }
 
 std::vector<const workspace_t*> workspace_graph_t::workspaces() const {
@@ -512,190 +1010,236 @@ std::vector<const workspace_t*> workspace_graph_t::workspaces() const {
 }
 
 std::vector<const module_t*> workspace_graph_t::modules() const {
-    std::vector<const module_t*> result;
-
-    for (const auto* workspace : workspaces()) {
-        for (const auto* module : workspace->modules()) {
-            result.push_back(module);
-        }
-    }
-
+    const auto& modules = m_storage->modules();
+    std::vector<const module_t*> result(modules.begin(), modules.end());
     std::sort(result.begin(), result.end(), module_less);
 
     return result;
 }
 
-module_t* workspace_graph_t::discover_module_impl(module_name_t module_name) {
-    const auto it = m_workspace_by_module_name.find(module_name);
-    if (it == m_workspace_by_module_name.end()) {
+module_t* workspace_graph_t::make_module(const module_name_t& module_name, std::vector<module_t*>& unloaded_modules) {
+    auto* module_name_entry = m_storage->find_module_name(module_name);
+
+    // Only a single path component names a directory inside the workspace.
+    const auto& name = module_name.string();
+    const bool is_directory_name = !name.empty() && name != "." && name != ".." && name.find('/') == std::string::npos;
+    if (module_name_entry == nullptr && is_directory_name) {
+        // The first workspace in order that has <workspace>/<module>/deps.json owns the name; see verify().
+        for (auto* workspace : m_storage->workspaces()) {
+            const auto module_json_path = root() / workspace->relative_path() / m03gagbhsnusi43zogoacgj2ez_filesystem::relative_path_t(module_name.string()) / m03gagbhsnusi43zogoacgj2ez_filesystem::relative_path_t(MODULE_JSON);
+            if (m03gagbhsnusi43zogoacgj2ez_filesystem::exists(module_json_path)) {
+                module_name_entry = &m_storage->add_module_name(module_name, *workspace);
+                break ;
+            }
+        }
+    }
+    if (module_name_entry == nullptr) {
         throw std::runtime_error(std::format(
-            "m03gagbhsp2drqq3gkop8pzfrm_workspace_graph::workspace_graph_t::discover_module_impl: module '{}' not found in workspace graph",
+            "m03gagbhsp2drqq3gkop8pzfrm_workspace_graph::workspace_graph_t::make_module: module '{}' not found in workspace graph",
             module_name
         ));
     }
-
-    const auto workspace_relative_path = it->second->relative_path();
-    auto workspace_it = m_workspace_by_relative_path.find(workspace_relative_path);
-    if (workspace_it == m_workspace_by_relative_path.end()) {
-        throw std::runtime_error(std::format("m03gagbhsp2drqq3gkop8pzfrm_workspace_graph::discover_module_impl: workspace '{}' is not listed in workspace order manifest '{}'", workspace_relative_path, WORKSPACES_JSON));
-    }
-    auto workspace = workspace_it->second;
-    if (auto* discovered_module = workspace->find_module(module_name); discovered_module != nullptr) {
-        return discovered_module;
+    if (module_name_entry->module != nullptr) {
+        return module_name_entry->module;
     }
 
-    const auto module_directory = root() / workspace_relative_path / m03gagbhsnusi43zogoacgj2ez_filesystem::relative_path_t(module_name.string());
+    auto& workspace = *module_name_entry->workspace;
+    const auto module_directory = root() / workspace.relative_path() / m03gagbhsnusi43zogoacgj2ez_filesystem::relative_path_t(module_name.string());
     const auto module_version = version_t(module_directory);
-    auto module = new module_t(*workspace, module_name, module_version);
+    auto& module = m_storage->make_module(workspace, module_name, module_version);
+
+    module_name_entry->module = &module;
+    workspace.add_module(&module);
+    m_storage->add_module(module);
+    unloaded_modules.push_back(&module);
+
+    return &module;
+}
+
+module_t* workspace_graph_t::discover_module_impl(module_name_t module_name) {
+    std::vector<module_t*> unloaded_modules;
+    auto* result = make_module(module_name, unloaded_modules);
 
-    workspace->add_module(module);
+    // Worklist instead of recursion: dependency chains can be arbitrarily deep.
+    while (!unloaded_modules.empty()) {
+        auto* module = unloaded_modules.back();
+        unloaded_modules.pop_back();
+
+        json_module_t json_module;
+        {
+            const auto module_json_path = module->source_dir() / m03gagbhsnusi43zogoacgj2ez_filesystem::relative_path_t(MODULE_JSON);
+            if (!m03gagbhsnusi43zogoacgj2ez_filesystem::exists(module_json_path)) {
+                throw std::runtime_error(std::format("m03gagbhsp2drqq3gkop8pzfrm_workspace_graph::discover_module_impl: file does not exist: '{}'", module_json_path));
+            }
 
-    json_module_t json_module;
-    {
-        const auto module_json_path = module_directory / m03gagbhsnusi43zogoacgj2ez_filesystem::relative_path_t(MODULE_JSON);
-        if (!m03gagbhsnusi43zogoacgj2ez_filesystem::exists(module_json_path)) {
-            throw std::runtime_error(std::format("m03gagbhsp2drqq3gkop8pzfrm_workspace_graph::discover_module_impl: file does not exist: '{}'", module_json_path));
+            std::ifstream ifs(module_json_path.string());
+            if (!ifs) {
+                throw std::runtime_error(std::format("m03gagbhsp2drqq3gkop8pzfrm_workspace_graph::discover_module_impl: failed to open file '{}'", module_json_path));
+            }
+
+            try {
+                nlohmann::json json = nlohmann::json::parse(ifs);
+                json_module = json.get<decltype(json_module)>();
+            } catch (const nlohmann::json::parse_error& e) {
+                throw std::runtime_error(std::format("m03gagbhsp2drqq3gkop8pzfrm_workspace_graph::discover_module_impl: failed to parse JSON file '{}': {}", module_json_path, e.what()));
+            } catch (const nlohmann::json::exception& e) {
+                throw std::runtime_error(std::format("m03gagbhsp2drqq3gkop8pzfrm_workspace_graph::discover_module_impl: failed to get JSON module from file '{}': {}", module_json_path, e.what()));
+            }
         }
 
-        std::ifstream ifs(module_json_path.string());
-        if (!ifs) {
-            throw std::runtime_error(std::format("m03gagbhsp2drqq3gkop8pzfrm_workspace_graph::discover_module_impl: failed to open file '{}'", module_json_path));
+        for (const auto& module_dependency : json_module.module_dependencies) {
+            module->add_dependency(*make_module(module_name_t(module_dependency), unloaded_modules));
         }
 
-        try {
-            nlohmann::json json = nlohmann::json::parse(ifs);
-            json_module = json.get<decltype(json_module)>();
-        } catch (const nlohmann::json::parse_error& e) {
-            throw std::runtime_error(std::format("m03gagbhsp2drqq3gkop8pzfrm_workspace_graph::discover_module_impl: failed to parse JSON file '{}': {}", module_json_path, e.what()));
-        } catch (const nlohmann::json::exception& e) {
-            throw std::runtime_error(std::format("m03gagbhsp2drqq3gkop8pzfrm_workspace_graph::discover_module_impl: failed to get JSON module from file '{}': {}", module_json_path, e.what()));
+        for (const auto& builder_dependency : json_module.builder_dependencies) {
+            module->add_builder_dependency(*make_module(module_name_t(builder_dependency), unloaded_modules));
         }
     }
 
-    for (const auto& module_dependency : json_module.module_dependencies) {
-        module->add_dependency(*discover_module_impl(module_name_t(module_dependency)));
-    }
+    return result;
+}
 
-    for (const auto& builder_dependency : json_module.builder_dependencies) {
-        module->add_builder_dependency(*discover_module_impl(module_name_t(builder_dependency)));
+/**
+ * Iterative Tarjan over modules, which must be the contiguous index range of one freeze().
+ *
+ * successor(module, position) returns the position-th outgoing edge or nullptr past the last one.
+ * Edges into earlier index ranges are skipped, as those modules are already condensed and cannot reach back.
+ * emit_scc receives each component in dependency-to-dependent order.
+ */
+template <class successor_t, class emit_scc_t>
+static void strong_connect(const std::vector<module_t*>& modules, const successor_t& successor, const emit_scc_t& emit_scc) {
+    if (modules.empty()) {
+        return ;
     }
 
-    return module;
-}
+    const auto first_index = modules.front()->index();
+    std::vector<module_info_t> module_infos(modules.size(), module_info_t {
+        .index = -1,
+        .lowlink = -1,
+        .on_stack = false
+    });
+    const auto module_info = [&](const module_t& module) -> module_info_t* {
+        if (module.index() < first_index) {
+            return nullptr;
+        }
 
-static void strong_connect(
-    module_t* module,
-    uint32_t& index,
-    std::stack<module_t*>& S,
-    std::unordered_map<module_t*, module_info_t>& module_info_by_module,
-    workspace_graph_storage_t& graph_storage
-) {
-    const auto module_info_by_module_it = module_info_by_module.find(module);
-    if (module_info_by_module_it == module_info_by_module.end()) {
-        throw std::runtime_error("m03gagbhsp2drqq3gkop8pzfrm_workspace_graph::strong_connect: module not found in module_info_by_module");
-    }
-
-    auto& module_info = module_info_by_module_it->second;
-    module_info.index = index;
-    module_info.lowlink = index;
-    ++index;
-    S.push(module);
-    module_info.on_stack = true;
-
-    for (auto* dependency : module->dependencies()) {
-        const auto dependency_module_info_by_module_it = module_info_by_module.find(dependency);
-        if (dependency_module_info_by_module_it == module_info_by_module.end()) {
-            throw std::runtime_error("m03gagbhsp2drqq3gkop8pzfrm_workspace_graph::strong_connect: dependency module not found in module_info_by_module");
-        }
-        const auto& dependency_module_info = dependency_module_info_by_module_it->second;
-        if (dependency_module_info.index == -1) {
-            strong_connect(dependency, index, S, module_info_by_module, graph_storage);
-            module_info.lowlink = std::min(module_info.lowlink, dependency_module_info.lowlink);
-        } else if (dependency_module_info.on_stack) {
-            module_info.lowlink = std::min(module_info.lowlink, dependency_module_info.index);
-        }
-    }
-
-    if (module_info.lowlink == module_info.index) {
-        module_scc_t* module_scc = new module_scc_t;
-        while (1) {
-            const auto neighbor_module = S.top();
-            S.pop();
-            const auto neighbor_module_info_by_module_it = module_info_by_module.find(neighbor_module);
-            if (neighbor_module_info_by_module_it == module_info_by_module.end()) {
-                throw std::runtime_error("m03gagbhsp2drqq3gkop8pzfrm_workspace_graph::strong_connect: neighbor module not found in module_info_by_module");
-            }
-            auto& neighbor_module_info = neighbor_module_info_by_module_it->second;
-            neighbor_module_info.on_stack = false;
-            module_scc->add_module(*neighbor_module);
-            graph_storage.scc(*neighbor_module, *module_scc);
-            
-            if (neighbor_module == module) {
-                break ;
-            }
+        return &module_infos[module.index() - first_index];
+    };
+
+    int index = 0;
+    std::vector<module_t*> S;
+    std::vector<strong_connect_frame_t> frames;
+    const auto visit = [&](module_t* module) {
+        auto* info = module_info(*module);
+        info->index = index;
+        info->lowlink = index;
+        info->on_stack = true;
+        ++index;
+        S.push_back(module);
+        frames.push_back(strong_connect_frame_t {
+            .module = module,
+            .position = 0
+        });
+    };
+
+    for (auto* root : modules) {
+        if (module_info(*root)->index != -1) {
+            continue ;
         }
-    }
-}
 
-static version_t version_sccs(module_scc_t* scc, std::unordered_map<module_scc_t*, version_t>& visited, version_t minimum_version) {
-    if (auto it = visited.find(scc); it != visited.end()) {
-        return it->second;
-    }
+        visit(root);
+        while (!frames.empty()) {
+            auto* module = frames.back().module;
+            auto* info = module_info(*module);
 
-    version_t result = minimum_version;
+            if (auto* dependency = successor(*module, frames.back().position); dependency != nullptr) {
+                ++frames.back().position;
 
-    for (const auto& dependency : scc->dependencies()) {
-        result.value = std::max(result.value, version_sccs(dependency, visited, minimum_version).value);
-    }
+                auto* dependency_info = module_info(*dependency);
+                if (dependency_info == nullptr) {
+                    continue ;
+                }
 
-    for (const auto& module : scc->modules()) {
-        result.value = std::max(result.value, module->version().value);
-    }
+                if (dependency_info->index == -1) {
+                    visit(dependency);
+                } else if (dependency_info->on_stack) {
+                    info->lowlink = std::min(info->lowlink, dependency_info->index);
+                }
+                continue ;
+            }
 
-    for (auto& module : scc->modules()) {
-        module->version(result);
-    }
+            frames.pop_back();
+            if (!frames.empty()) {
+                auto* parent_info = module_info(*frames.back().module);
+                parent_info->lowlink = std::min(parent_info->lowlink, info->lowlink);
+            }
 
-    visited.emplace(scc, result);
+            if (info->lowlink == info->index) {
+                auto begin = S.size();
+                do {
+                    --begin;
+                    module_info(*S[begin])->on_stack = false;
+                } while (S[begin] != module);
 
-    return result;
+                emit_scc(std::span<module_t* const>(S.data() + begin, S.size() - begin));
+                S.resize(begin);
+            }
+        }
+    }
 }
 
 static void validate_module(
     const workspace_graph_t& workspace_graph,
     module_t* module,
-    std::unordered_set<module_t*>& validated_modules
+    std::vector<bool>& validated_modules
 ) {
-    if (!validated_modules.insert(module).second) {
-        return ;
-    }
+    std::vector<module_t*> pending { module };
+
+    while (!pending.empty()) {
+        auto* current = pending.back();
+        pending.pop_back();
 
-    const auto order_position = module->workspace().order_position();
-    for (auto* module_dependency : module->dependencies()) {
-        const auto module_dependency_order_position = module_dependency->workspace().order_position();
-        if (!(module_dependency_order_position <= order_position)) {
-            throw std::runtime_error(std::format("m03gagbhsp2drqq3gkop8pzfrm_workspace_graph::validate_module: module (workspace: {}, module: {}, order position: {}) cannot depend on later workspace module (workspace: {}, module: {}, order position: {})", module->workspace().relative_path(), module->name(), order_position, module_dependency->workspace().relative_path(), module_dependency->name(), module_dependency_order_position));
+        if (validated_modules[current->index()]) {
+            continue ;
         }
+        validated_modules[current->index()] = true;
 
-        validate_module(workspace_graph, module_dependency, validated_modules);
-    }
+        const auto order_position = current->workspace().order_position();
+        for (auto* module_dependency : current->dependencies()) {
+            const auto module_dependency_order_position = module_dependency->workspace().order_position();
+            if (!(module_dependency_order_position <= order_position)) {
+                throw std::runtime_error(std::format("m03gagbhsp2drqq3gkop8pzfrm_workspace_graph::validate_module: module (workspace: {}, module: {}, order position: {}) cannot depend on later workspace module (workspace: {}, module: {}, order position: {})", current->workspace().relative_path(), current->name(), order_position, module_dependency->workspace().relative_path(), module_dependency->name(), module_dependency_order_position));
+            }
 
-    for (auto* builder_dependency : module->builder_dependencies()) {
-        const auto builder_dependency_order_position = builder_dependency->workspace().order_position();
-        const bool bootstrap_group_dependency =
-            workspace_graph.is_active_builder_bootstrap_module(*module)
-            && workspace_graph.is_active_builder_bootstrap_module(*builder_dependency);
-        if (!(builder_dependency_order_position < order_position) && !bootstrap_group_dependency) {
-            throw std::runtime_error(std::format("m03gagbhsp2drqq3gkop8pzfrm_workspace_graph::validate_module: builder (workspace: {}, module: {}, order position: {}) cannot depend on same or later workspace module (workspace: {}, module: {}, order position: {})", module->workspace().relative_path(), module->name(), order_position, builder_dependency->workspace().relative_path(), builder_dependency->name(), builder_dependency_order_position));
+            pending.push_back(module_dependency);
         }
 
-        validate_module(workspace_graph, builder_dependency, validated_modules);
+        for (auto* builder_dependency : current->builder_dependencies()) {
+            const auto builder_dependency_order_position = builder_dependency->workspace().order_position();
+            const bool bootstrap_group_dependency =
+                workspace_graph.is_active_builder_bootstrap_module(*current)
+                && workspace_graph.is_active_builder_bootstrap_module(*builder_dependency);
+            if (!(builder_dependency_order_position < order_position) && !bootstrap_group_dependency) {
+                throw std::runtime_error(std::format("m03gagbhsp2drqq3gkop8pzfrm_workspace_graph::validate_module: builder (workspace: {}, module: {}, order position: {}) cannot depend on same or later workspace module (workspace: {}, module: {}, order position: {})", current->workspace().relative_path(), current->name(), order_position, builder_dependency->workspace().relative_path(), builder_dependency->name(), builder_dependency_order_position));
+            }
+
+            pending.push_back(builder_dependency);
+        }
     }
 }
 
 module_t* workspace_graph_t::discover_module(module_name_t module_name) {
+    return discover_modules({ std::move(module_name) }).front();
+}
+
+std::vector<module_t*> workspace_graph_t::discover_modules(const std::vector<module_name_t>& module_names) {
     load_module_index();
-    auto* result = discover_module_impl(module_name);
+
+    std::vector<module_t*> result;
+    result.reserve(module_names.size());
+    for (const auto& module_name : module_names) {
+        result.push_back(discover_module_impl(module_name));
+    }
 
     auto bootstrap_seed_workspace_it = m_workspace_by_relative_path.find(m03gagbhsnusi43zogoacgj2ez_filesystem::relative_path_t(BOOTSTRAP_SEED_WORKSPACE));
     if (bootstrap_seed_workspace_it == m_workspace_by_relative_path.end()) {
@@ -705,77 +1249,73 @@ module_t* workspace_graph_t::discover_module(module_name_t module_name) {
     m_bootstrap_seed_workspace = bootstrap_seed_workspace_it->second;
     m_bootstrap_seed_module = bootstrap_seed_module;
 
-    std::unordered_map<module_t*, module_info_t> module_info_by_module;
-    for (const auto& [_, workspace] : m_workspace_by_relative_path) {
-        for (auto* module : workspace->modules()) {
-            module_info_by_module[module] = module_info_t {
-                .index = -1,
-                .lowlink = -1,
-                .on_stack = false
-            };
-        }
-    }
+    // Modules discovered by earlier calls cannot reach new modules, so their SCCs and versions are final.
+    const auto modules = m_storage->freeze();
 
-    uint32_t index = 0;
-    std::stack<module_t*> S;
-    m_storage->clear_sccs();
-    for (const auto& [module, module_info] : module_info_by_module) {
-        if (module_info.index == -1) {
-            strong_connect(module, index, S, module_info_by_module, *m_storage);
+    const auto module_successor = [&](const module_t& module, uint32_t position) -> module_t* {
+        const auto dependencies = m_storage->dependencies(module);
+        return position < dependencies.size() ? dependencies[position] : nullptr;
+    };
+    strong_connect(modules, module_successor, [&](std::span<module_t* const> scc_modules) {
+        module_scc_t* module_scc = &m_storage->make_scc();
+        for (auto it = scc_modules.rbegin(); it != scc_modules.rend(); ++it) {
+            module_scc->add_module(**it);
+            m_storage->scc(**it, *module_scc);
         }
-    }
 
-    std::unordered_map<module_scc_t*, std::unordered_set<module_scc_t*>> module_scc_dependencies_by_module_scc;
-    for (const auto& [_, workspace] : m_workspace_by_relative_path) {
-        for (auto* module : workspace->modules()) {
-            for (auto* dependency : module->dependencies()) {
+        std::unordered_set<module_scc_t*> module_scc_dependencies;
+        for (auto* module : module_scc->modules()) {
+            for (auto* dependency : m_storage->dependencies(*module)) {
                 auto& dependency_scc = m_storage->scc(*dependency);
-                auto& module_scc = m_storage->scc(*module);
-
-                if (&dependency_scc != &module_scc && module_scc_dependencies_by_module_scc[&module_scc].insert(&dependency_scc).second) {
-                    module_scc.add_dependency(dependency_scc);
+                if (&dependency_scc != module_scc && module_scc_dependencies.insert(&dependency_scc).second) {
+                    module_scc->add_dependency(dependency_scc);
                 }
             }
         }
-    }
+    });
 
-    std::vector<module_t*> modules;
-    for (const auto& [_, workspace] : m_workspace_by_relative_path) {
-        for (auto* module : workspace->modules()) {
-            modules.push_back(module);
+    // A module's version is the latest version reachable through module and builder dependencies.
+    // Components of the combined graph arrive dependencies first, so one pass settles every version.
+    const auto versioning_successor = [&](const module_t& module, uint32_t position) -> module_t* {
+        const auto dependencies = m_storage->dependencies(module);
+        if (position < dependencies.size()) {
+            return dependencies[position];
         }
-    }
 
-    const auto propagate_module_dependency_versions = [&]() {
-        std::unordered_map<module_scc_t*, version_t> visited;
-        for (auto* module : modules) {
-            version_sccs(&m_storage->scc(*module), visited, m_bootstrap_seed_module->version());
-        }
+        const auto builder_dependencies = m_storage->builder_dependencies(module);
+        position -= static_cast<uint32_t>(dependencies.size());
+        return position < builder_dependencies.size() ? builder_dependencies[position] : nullptr;
     };
-
-    for (std::size_t i = 0; i <= modules.size(); ++i) {
-        propagate_module_dependency_versions();
-
-        bool changed = false;
-        for (auto* module : modules) {
-            version_t builder_version = module->version();
-            for (auto* builder_dependency : module->builder_dependencies()) {
-                builder_version.value = std::max(builder_version.value, builder_dependency->version().value);
+    strong_connect(modules, versioning_successor, [&](std::span<module_t* const> scc_modules) {
+        m_storage->add_component(scc_modules);
+
+        version_t scc_version(0);
+        for (auto* module : scc_modules) {
+            scc_version.value = std::max(scc_version.value, module->version().value);
+            for (auto* dependency : m_storage->dependencies(*module)) {
+                scc_version.value = std::max(scc_version.value, dependency->version().value);
             }
-
-            if (module->version().value < builder_version.value) {
-                module->version(builder_version);
-                changed = true;
+            for (auto* builder_dependency : m_storage->builder_dependencies(*module)) {
+                scc_version.value = std::max(scc_version.value, builder_dependency->version().value);
             }
         }
 
-        if (!changed) {
-            break ;
+        for (auto* module : scc_modules) {
+            module->version(scc_version);
+        }
+    });
+
+    const auto minimum_version = m_bootstrap_seed_module->version();
+    for (auto* module : modules) {
+        if (module->version().value < minimum_version.value) {
+            module->version(minimum_version);
         }
     }
 
-    std::unordered_set<module_t*> validated_modules;
-    validate_module(*this, result, validated_modules);
+    std::vector<bool> validated_modules(m_storage->modules().size(), false);
+    for (auto* module : result) {
+        validate_module(*this, module, validated_modules);
+    }
 
     return result;
 }
@@ -5,10 +5,11 @@
 
 # include <cstdint>
 # include <functional>
+# include <optional>
+# include <span>
 # include <string>
 # include <string_view>
 # include <utility>
-# include <unordered_set>
 # include <unordered_map>
 # include <vector>
 
@@ -42,49 +43,61 @@ struct version_t {
 };
 
 /**
- * Workspace and artifact roots for the current process.
+ * Workspace, artifact and scratch roots for the current process.
  */
 struct invocation_context_t {
     m03gagbhsnusi43zogoacgj2ez_filesystem::path_t workspace_root;
     m03gagbhsnusi43zogoacgj2ez_filesystem::path_t artifact_root;
+    m03gagbhsnusi43zogoacgj2ez_filesystem::path_t scratch_root;
 };
 
 /**
- * Non-empty module name.
+ * Non-empty module name, interned for the lifetime of the process.
+ *
+ * Equal names share one string, so a copy is a pointer copy and comparison is a pointer comparison.
  */
 class module_name_t {
 public:
     /**
-     * Throws if name is empty.
+     * Interns name on first use. Throws if name is empty.
      */
     explicit module_name_t(std::string_view name);
 
     const std::string& string() const;
     const char* c_str() const;
+
+    /**
+     * Hash of the string value, computed once when the name is interned.
+     */
+    std::size_t hash() const;
+
     bool operator==(const module_name_t& other) const;
 
 private:
-    std::string m_name;
+    struct interned_t;
+
+    const interned_t* m_interned;
 };
 
 /**
- * Hashes module_name_t by its string value.
+ * Hashes module_name_t by its precomputed string hash.
  */
 struct module_name_hash_t {
     std::size_t operator()(const module_name_t& module_name) const noexcept {
-        return std::hash<std::string>()(module_name.string());
+        return module_name.hash();
     }
 };
 
 class workspace_t;
+class workspace_graph_storage_t;
 
 /**
  * Discovered module.
  */
 class module_t {
 public:
-    using group_t = std::vector<module_t*>;
-    using groups_t = std::vector<group_t>;
+    using group_t = std::span<module_t* const>;
+    using groups_t = std::span<const group_t>;
 
     module_t(workspace_t& workspace, module_name_t name, version_t version);
 
@@ -108,6 +121,11 @@ public:
      */
     void version(version_t version);
 
+    /**
+     * Latest timestamp under source_dir() when the module was discovered, before dependency versions were applied.
+     */
+    version_t source_version() const;
+
     /**
      * Adds a module dependency.
      */
@@ -118,20 +136,27 @@ public:
      */
     void add_builder_dependency(module_t& dependency);
 
+    /**
+     * Dense graph index, assigned in discovery order; modules discovered by the same call are indexed in workspace order and name order.
+     */
+    uint32_t index() const;
+
     /**
      * Module dependencies sorted by workspace order and name.
      */
-    std::vector<module_t*> dependencies();
-    std::vector<const module_t*> dependencies() const;
+    std::span<module_t* const> dependencies();
+    std::span<const module_t* const> dependencies() const;
 
     /**
      * Builder dependencies sorted by workspace order and name.
      */
-    std::vector<module_t*> builder_dependencies();
-    std::vector<const module_t*> builder_dependencies() const;
+    std::span<module_t* const> builder_dependencies();
+    std::span<const module_t* const> builder_dependencies() const;
 
     /**
      * Module dependency closure as strongly connected component groups in dependency-to-dependent topological order.
+     *
+     * Computed once per component and shared by all of its modules; valid for the lifetime of the graph.
      */
     groups_t closure_groups() const;
 
@@ -155,12 +180,21 @@ public:
      */
     m03gagbhsnusi43zogoacgj2ez_filesystem::path_t artifact_latest_dir() const;
 
+    /**
+     * Versioned scratch directory: <scratch_root>/<module>/<module>@<version>.
+     */
+    m03gagbhsnusi43zogoacgj2ez_filesystem::path_t artifact_scratch_dir() const;
+
 private:
+    friend workspace_graph_storage_t;
+
     workspace_t* m_workspace;
     version_t m_version;
+    version_t m_source_version;
     module_name_t m_name;
-    std::unordered_set<module_t*> m_dependencies;
-    std::unordered_set<module_t*> m_builder_dependencies;
+    uint32_t m_index;
+    std::vector<module_t*> m_declared_dependencies;
+    std::vector<module_t*> m_declared_builder_dependencies;
 };
 
 class workspace_graph_t;
@@ -209,14 +243,23 @@ private:
     std::unordered_map<module_name_t, module_t*, module_name_hash_t> m_module_by_name;
 };
 
-class workspace_graph_storage_t;
-
 /**
  * Module graph for one workspace root and artifact root.
  */
 class workspace_graph_t {
 public:
-    workspace_graph_t(m03gagbhsnusi43zogoacgj2ez_filesystem::path_t workspace_root, m03gagbhsnusi43zogoacgj2ez_filesystem::path_t artifact_dir);
+    /**
+     * Scratch root defaults to the artifact root.
+     */
+    workspace_graph_t(
+        m03gagbhsnusi43zogoacgj2ez_filesystem::path_t workspace_root,
+        m03gagbhsnusi43zogoacgj2ez_filesystem::path_t artifact_dir,
+        std::optional<m03gagbhsnusi43zogoacgj2ez_filesystem::path_t> scratch_dir = std::nullopt
+    );
+    ~workspace_graph_t();
+
+    workspace_graph_t(const workspace_graph_t&) = delete;
+    workspace_graph_t& operator=(const workspace_graph_t&) = delete;
 
     /**
      * Workspace root directory.
@@ -228,6 +271,11 @@ public:
      */
     const m03gagbhsnusi43zogoacgj2ez_filesystem::path_t& artifact_root() const;
 
+    /**
+     * Root for phase build directories, which need not survive the process that builds them.
+     */
+    const m03gagbhsnusi43zogoacgj2ez_filesystem::path_t& scratch_root() const;
+
     /**
      * Module used as the active Builder bootstrap seed.
      */
@@ -238,11 +286,51 @@ public:
      */
     bool is_active_builder_bootstrap_module(const module_t& module) const;
 
+    /**
+     * True if dependency is module or is reachable from it through module and builder dependencies.
+     */
+    bool reaches(const module_t& module, const module_t& dependency) const;
+
+    /**
+     * Modules that reach module through module and builder dependencies, sorted by workspace order and name.
+     */
+    std::vector<const module_t*> dependents(const module_t& module) const;
+
     /**
      * Discovers module_name, its reachable dependencies, and validates them.
+     *
+     * Only modules not discovered by earlier calls are condensed and versioned.
      */
     module_t* discover_module(module_name_t module_name);
 
+    /**
+     * Scans every workspace directory and returns the number of modules found.
+     *
+     * Throws if a module name exists in more than one workspace. discover_module resolves names lazily
+     * to the first workspace in order and does not detect duplicates.
+     */
+    std::size_t verify();
+
+    /**
+     * Discovers every module found by verify(), so dependents() covers the whole workspace graph.
+     */
+    void discover_all_modules();
+
+    /**
+     * Destroys every workspace, module, and SCC; the next discover_module reloads workspaces.json.
+     *
+     * Arena memory is kept for reuse. Invalidates all references into the graph.
+     */
+    void clear();
+
+    /**
+     * Returns whether workspaces.json or a file under a discovered module's source_dir() changed since it was
+     * loaded, leaving module versions stale until clear().
+     *
+     * Stats every file of every discovered module; for long-lived processes, such as the build server.
+     */
+    bool is_stale() const;
+
     /**
      * Workspaces sorted by workspaces.json order.
      */
@@ -253,6 +341,16 @@ public:
      */
     std::vector<const module_t*> modules() const;
 
+    /**
+     * Module dependencies of module, sorted by workspace order and name.
+     */
+    std::span<module_t* const> dependencies(const module_t& module) const;
+
+    /**
+     * Builder dependencies of module, sorted by workspace order and name.
+     */
+    std::span<module_t* const> builder_dependencies(const module_t& module) const;
+
     /**
      * Module dependency closure as strongly connected component groups in dependency-to-dependent topological order.
      */
@@ -260,20 +358,28 @@ public:
 
 private:
     void load_module_index();
+    std::vector<module_name_t> scan_module_names();
+    std::vector<module_t*> discover_modules(const std::vector<module_name_t>& module_names);
     module_t* discover_module_impl(module_name_t module_name);
+    module_t* make_module(const module_name_t& module_name, std::vector<module_t*>& unloaded_modules);
 
 private:
     std::unordered_map<m03gagbhsnusi43zogoacgj2ez_filesystem::relative_path_t, workspace_t*> m_workspace_by_relative_path;
-    std::unordered_map<module_name_t, const workspace_t*, module_name_hash_t> m_workspace_by_module_name;
     m03gagbhsnusi43zogoacgj2ez_filesystem::path_t m_root;
     m03gagbhsnusi43zogoacgj2ez_filesystem::path_t m_artifact_root;
+    m03gagbhsnusi43zogoacgj2ez_filesystem::path_t m_scratch_root;
     workspace_t* m_bootstrap_seed_workspace;
     module_t* m_bootstrap_seed_module;
+    std::optional<version_t> m_workspaces_json_version;
     workspace_graph_storage_t* m_storage;
 };
 
 /**
- * Reads BUILDER_WORKSPACE_ROOT and BUILDER_ARTIFACT_ROOT, applies defaults, and exports the selected values.
+ * Reads BUILDER_WORKSPACE_ROOT, BUILDER_ARTIFACT_ROOT and BUILDER_SCRATCH_ROOT, applies defaults, and exports the
+ * selected values.
+ *
+ * BUILDER_SCRATCH_ROOT defaults to the artifact root and is exported only when set, so a child that moves
+ * BUILDER_ARTIFACT_ROOT also moves its scratch.
  */
 invocation_context_t invocation_context();
 
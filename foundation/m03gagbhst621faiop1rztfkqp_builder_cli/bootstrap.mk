@@ -58,7 +58,8 @@ BOOTSTRAP_MODULES := \
 	m03gagbhsujjf63n0w3r2w4q6h_build_phases \
 	m03gagbhsvr0m5w15urj0o291m_process \
 	m03gagbhsyhlx2pk5sdabbr1sx_signal_handler \
-	m03gagbhsx4j5z28bqkac3dhhh_shared_library
+	m03gagbhsx4j5z28bqkac3dhhh_shared_library \
+	m03h2qrcln2fdgjro7rajbqejh_elf
 
 BOOTSTRAP_INCLUDE_LINKS := $(addprefix $(BOOTSTRAP_INCLUDE_DIR)/,$(BOOTSTRAP_MODULES))
 
@@ -68,9 +69,11 @@ SRC := \
 	$(FOUNDATION_DIR)/m03gagbhsvr0m5w15urj0o291m_process/process.cpp \
 	$(FOUNDATION_DIR)/m03gagbhsmhr0naw0zpccv4gaq_cxx_toolchain/cxx_toolchain.cpp \
 	$(FOUNDATION_DIR)/m03gagbhsx4j5z28bqkac3dhhh_shared_library/shared_library.cpp \
+	$(FOUNDATION_DIR)/m03h2qrcln2fdgjro7rajbqejh_elf/elf.cpp \
 	$(FOUNDATION_DIR)/m03gagbhsp2drqq3gkop8pzfrm_workspace_graph/workspace_graph.cpp \
 	$(FOUNDATION_DIR)/m03gagbhsujjf63n0w3r2w4q6h_build_phases/build_phases.cpp \
 	$(FOUNDATION_DIR)/m03gagbhst621faiop1rztfkqp_builder_cli/builder_cli.cpp \
+	$(FOUNDATION_DIR)/m03gagbhst621faiop1rztfkqp_builder_cli/build_server.cpp \
 	$(BOOTSTRAP_SEED_DIR)/cli.cpp
 
 BOOTSTRAP_SEED_BUILDER_SRC := \
@@ -79,9 +82,11 @@ BOOTSTRAP_SEED_BUILDER_SRC := \
 	$(FOUNDATION_DIR)/m03gagbhsvr0m5w15urj0o291m_process/process.cpp \
 	$(FOUNDATION_DIR)/m03gagbhsmhr0naw0zpccv4gaq_cxx_toolchain/cxx_toolchain.cpp \
 	$(FOUNDATION_DIR)/m03gagbhsx4j5z28bqkac3dhhh_shared_library/shared_library.cpp \
+	$(FOUNDATION_DIR)/m03h2qrcln2fdgjro7rajbqejh_elf/elf.cpp \
 	$(FOUNDATION_DIR)/m03gagbhsp2drqq3gkop8pzfrm_workspace_graph/workspace_graph.cpp \
 	$(FOUNDATION_DIR)/m03gagbhsujjf63n0w3r2w4q6h_build_phases/build_phases.cpp \
 	$(FOUNDATION_DIR)/m03gagbhst621faiop1rztfkqp_builder_cli/builder_cli.cpp \
+	$(FOUNDATION_DIR)/m03gagbhst621faiop1rztfkqp_builder_cli/build_server.cpp \
 	$(BOOTSTRAP_SEED_DIR)/builder.cpp
 
 .PHONY: bootstrap
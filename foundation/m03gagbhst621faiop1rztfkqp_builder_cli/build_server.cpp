@@ -0,0 +1,423 @@
+#include "build_server.h"
+
+#include <m03gagbhsnusi43zogoacgj2ez_filesystem/filesystem.h>
+#include <m03gagbhsujjf63n0w3r2w4q6h_build_phases/build_phases.h>
+#include <m03gagbhsvr0m5w15urj0o291m_process/process.h>
+
+#include <cerrno>
+#include <csignal>
+#include <cstring>
+#include <exception>
+#include <format>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace m03gagbhst621faiop1rztfkqp_builder_cli {
+
+/*
+ * Protocol: the client sends "builder-request 2\n<workspace root>\n<scratch root>\n<module>\n" with its stdout and stderr
+ * attached as SCM_RIGHTS, then shuts down its write side. The server answers "ok\n<cli>\n<working dir>\n",
+ * "error\n<message>", or "fallback\n" when the client should build in-process, and closes the connection.
+ */
+static constexpr std::string_view REQUEST_HEADER = "builder-request 2";
+
+// Bounds how long a connected client may take to send its request; builds themselves are not limited.
+static constexpr int REQUEST_TIMEOUT_SECONDS = 5;
+
+// Builder plugins of superseded module versions stay mapped, so the server restarts after loading this many.
+static constexpr std::size_t MAX_LOADED_BUILDER_PLUGINS = 256;
+
+class fd_t {
+public:
+    explicit fd_t(int fd):
+        m_fd(fd)
+    {
+    }
+
+    ~fd_t() {
+        if (m_fd != -1) {
+            ::close(m_fd);
+        }
+    }
+
+    fd_t(fd_t&& other) noexcept:
+        m_fd(std::exchange(other.m_fd, -1))
+    {
+    }
+
+    fd_t(const fd_t&) = delete;
+    fd_t& operator=(const fd_t&) = delete;
+
+    int get() const {
+        return m_fd;
+    }
+
+private:
+    int m_fd;
+};
+
+/**
+ * Points stdout and stderr at a client's descriptors for one request and restores them afterwards.
+ */
+class scoped_output_redirect_t {
+public:
+    scoped_output_redirect_t(int out, int err):
+        m_saved_out(::dup(STDOUT_FILENO)),
+        m_saved_err(::dup(STDERR_FILENO))
+    {
+        std::cout.flush();
+        std::cerr.flush();
+        ::dup2(out, STDOUT_FILENO);
+        ::dup2(err, STDERR_FILENO);
+    }
+
+    ~scoped_output_redirect_t() {
+        std::cout.flush();
+        std::cerr.flush();
+        ::dup2(m_saved_out.get(), STDOUT_FILENO);
+        ::dup2(m_saved_err.get(), STDERR_FILENO);
+    }
+
+    scoped_output_redirect_t(const scoped_output_redirect_t&) = delete;
+    scoped_output_redirect_t& operator=(const scoped_output_redirect_t&) = delete;
+
+private:
+    fd_t m_saved_out;
+    fd_t m_saved_err;
+};
+
+static m03gagbhsnusi43zogoacgj2ez_filesystem::path_t socket_path(const m03gagbhsnusi43zogoacgj2ez_filesystem::path_t& artifact_root) {
+    return artifact_root / m03gagbhsnusi43zogoacgj2ez_filesystem::relative_path_t(BUILD_SERVER_SOCKET);
+}
+
+static std::optional<sockaddr_un> socket_address(const m03gagbhsnusi43zogoacgj2ez_filesystem::path_t& path) {
+    sockaddr_un address {};
+    address.sun_family = AF_UNIX;
+
+    const auto string = path.string();
+    if (sizeof(address.sun_path) <= string.size()) {
+        return std::nullopt;
+    }
+
+    std::memcpy(address.sun_path, string.c_str(), string.size() + 1);
+    return address;
+}
+
+static bool connect_to(const fd_t& socket, const sockaddr_un& address) {
+    return ::connect(socket.get(), reinterpret_cast<const sockaddr*>(&address), sizeof(address)) == 0;
+}
+
+static bool send_all(const fd_t& socket, std::string_view data) {
+    while (!data.empty()) {
+        const auto sent = ::send(socket.get(), data.data(), data.size(), MSG_NOSIGNAL);
+        if (sent == -1) {
+            if (errno == EINTR) {
+                continue ;
+            }
+            return false;
+        }
+        data.remove_prefix(static_cast<std::size_t>(sent));
+    }
+
+    return true;
+}
+
+/**
+ * Sends data with descriptors attached to its first byte.
+ */
+static bool send_with_descriptors(const fd_t& socket, std::string_view data, const std::vector<int>& descriptors) {
+    std::vector<char> control(CMSG_SPACE(sizeof(int) * descriptors.size()));
+    iovec iov {
+        .iov_base = const_cast<char*>(data.data()),
+        .iov_len = 1
+    };
+    msghdr message {};
+    message.msg_iov = &iov;
+    message.msg_iovlen = 1;
+    message.msg_control = control.data();
+    message.msg_controllen = control.size();
+
+    cmsghdr* header = CMSG_FIRSTHDR(&message);
+    header->cmsg_level = SOL_SOCKET;
+    header->cmsg_type = SCM_RIGHTS;
+    header->cmsg_len = CMSG_LEN(sizeof(int) * descriptors.size());
+    std::memcpy(CMSG_DATA(header), descriptors.data(), sizeof(int) * descriptors.size());
+
+    ssize_t sent;
+    do {
+        sent = ::sendmsg(socket.get(), &message, MSG_NOSIGNAL);
+    } while (sent == -1 && errno == EINTR);
+    if (sent != 1) {
+        return false;
+    }
+
+    return send_all(socket, data.substr(1));
+}
+
+/**
+ * Reads until end of stream, collecting any descriptors sent along. Returns false on a read error or timeout.
+ */
+static bool receive_all(const fd_t& socket, std::string& data, std::vector<fd_t>& descriptors) {
+    char buffer[4096];
+    alignas(cmsghdr) char control[CMSG_SPACE(sizeof(int) * 4)];
+
+    while (true) {
+        iovec iov {
+            .iov_base = buffer,
+            .iov_len = sizeof(buffer)
+        };
+        msghdr message {};
+        message.msg_iov = &iov;
+        message.msg_iovlen = 1;
+        message.msg_control = control;
+        message.msg_controllen = sizeof(control);
+
+        const auto received = ::recvmsg(socket.get(), &message, MSG_CMSG_CLOEXEC);
+        if (received == -1) {
+            if (errno == EINTR) {
+                continue ;
+            }
+            return false;
+        }
+
+        for (cmsghdr* header = CMSG_FIRSTHDR(&message); header != nullptr; header = CMSG_NXTHDR(&message, header)) {
+            if (header->cmsg_level == SOL_SOCKET && header->cmsg_type == SCM_RIGHTS) {
+                const auto count = (header->cmsg_len - CMSG_LEN(0)) / sizeof(int);
+                for (std::size_t i = 0; i < count; ++i) {
+                    int descriptor;
+                    std::memcpy(&descriptor, CMSG_DATA(header) + i * sizeof(int), sizeof(int));
+                    descriptors.emplace_back(descriptor);
+                }
+            }
+        }
+
+        if (received == 0) {
+            return true;
+        }
+        data.append(buffer, static_cast<std::size_t>(received));
+    }
+}
+
+static std::vector<std::string> split_lines(std::string_view data) {
+    std::vector<std::string> lines;
+    while (!data.empty()) {
+        const auto end = data.find('\n');
+        lines.emplace_back(data.substr(0, end));
+        if (end == std::string_view::npos) {
+            break ;
+        }
+        data.remove_prefix(end + 1);
+    }
+
+    return lines;
+}
+
+std::optional<resolved_cli_t> request_from_build_server(
+    const m03gagbhsp2drqq3gkop8pzfrm_workspace_graph::invocation_context_t& invocation_context,
+    const m03gagbhsp2drqq3gkop8pzfrm_workspace_graph::module_name_t& module
+) {
+    const auto address = socket_address(socket_path(invocation_context.artifact_root));
+    if (!address) {
+        return std::nullopt;
+    }
+
+    fd_t socket(::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0));
+    if (socket.get() == -1 || !connect_to(socket, *address)) {
+        return std::nullopt;
+    }
+
+    const auto request = std::format("{}\n{}\n{}\n{}\n", REQUEST_HEADER, invocation_context.workspace_root, invocation_context.scratch_root, module);
+    if (!send_with_descriptors(socket, request, { STDOUT_FILENO, STDERR_FILENO }) || ::shutdown(socket.get(), SHUT_WR) == -1) {
+        return std::nullopt;
+    }
+
+    std::string reply;
+    std::vector<fd_t> descriptors;
+    if (!receive_all(socket, reply, descriptors)) {
+        return std::nullopt;
+    }
+
+    const auto lines = split_lines(reply);
+    if (lines.size() == 3 && lines[0] == "ok") {
+        return resolved_cli_t {
+            .cli = m03gagbhsnusi43zogoacgj2ez_filesystem::path_t(lines[1]),
+            .working_dir = m03gagbhsnusi43zogoacgj2ez_filesystem::path_t(lines[2])
+        };
+    }
+
+    if (!lines.empty() && lines[0] == "error") {
+        throw std::runtime_error(reply.substr(std::string_view("error\n").size()));
+    }
+
+    // Anything else, including a server that went away mid-request, builds in-process.
+    return std::nullopt;
+}
+
+/**
+ * Outcome of one request: the reply for the client, and the seed CLI to hand the server over to, if any, and why.
+ */
+struct served_t {
+    std::string reply;
+    std::optional<m03gagbhsnusi43zogoacgj2ez_filesystem::path_t> handover_cli;
+    std::string handover_reason;
+};
+
+static served_t resolve(
+    const m03gagbhsp2drqq3gkop8pzfrm_workspace_graph::invocation_context_t& invocation_context,
+    m03gagbhsp2drqq3gkop8pzfrm_workspace_graph::workspace_graph_t& workspace_graph,
+    const m03gagbhsp2drqq3gkop8pzfrm_workspace_graph::module_name_t& module
+) {
+    // Versions come from source timestamps, so the graph is rediscovered only after a source edit.
+    if (workspace_graph.is_stale()) {
+        workspace_graph.clear();
+    }
+    auto* target_module = workspace_graph.discover_module(module);
+
+    // The client falls back to the in-process path, which execs the rebuilt seed CLI itself.
+    if (is_older_than_bootstrap_seed(workspace_graph)) {
+        return served_t {
+            .reply = "fallback\n",
+            .handover_cli = install_default_cli(workspace_graph.bootstrap_seed_module()).cli,
+            .handover_reason = "build server is older than the bootstrap seed"
+        };
+    }
+
+    const auto resolved = install_default_cli(*target_module);
+    m03gagbhsujjf63n0w3r2w4q6h_build_phases::collect_garbage_after_build(invocation_context);
+
+    served_t result {
+        .reply = std::format("ok\n{}\n{}\n", resolved.cli, resolved.working_dir),
+        .handover_cli = std::nullopt,
+        .handover_reason = {}
+    };
+    if (MAX_LOADED_BUILDER_PLUGINS <= m03gagbhsujjf63n0w3r2w4q6h_build_phases::loaded_builder_plugin_count()) {
+        result.handover_cli = install_default_cli(workspace_graph.bootstrap_seed_module()).cli;
+        result.handover_reason = std::format("build server has loaded {} builder plugins", m03gagbhsujjf63n0w3r2w4q6h_build_phases::loaded_builder_plugin_count());
+    }
+
+    return result;
+}
+
+static served_t serve_request(
+    const m03gagbhsp2drqq3gkop8pzfrm_workspace_graph::invocation_context_t& invocation_context,
+    m03gagbhsp2drqq3gkop8pzfrm_workspace_graph::workspace_graph_t& workspace_graph,
+    const fd_t& client
+) {
+    const timeval timeout {
+        .tv_sec = REQUEST_TIMEOUT_SECONDS,
+        .tv_usec = 0
+    };
+    ::setsockopt(client.get(), SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+
+    std::string request;
+    std::vector<fd_t> descriptors;
+    if (!receive_all(client, request, descriptors)) {
+        return served_t { .reply = "fallback\n", .handover_cli = std::nullopt, .handover_reason = {} };
+    }
+
+    const auto lines = split_lines(request);
+    if (
+        descriptors.size() != 2 ||
+        lines.size() != 4 ||
+        lines[0] != REQUEST_HEADER ||
+        lines[1] != invocation_context.workspace_root.string() ||
+        lines[2] != invocation_context.scratch_root.string()
+    ) {
+        return served_t { .reply = "fallback\n", .handover_cli = std::nullopt, .handover_reason = {} };
+    }
+
+    scoped_output_redirect_t output_redirect(descriptors[0].get(), descriptors[1].get());
+    const auto module = m03gagbhsp2drqq3gkop8pzfrm_workspace_graph::module_name_t(lines[3]);
+    try {
+        try {
+            return resolve(invocation_context, workspace_graph, module);
+        } catch (const std::exception&) {
+            // A discovery that failed part way leaves the graph incomplete.
+            workspace_graph.clear();
+
+            // Artifacts removed behind the server's back make remembered installs stale; retry once without them.
+            if (!m03gagbhsujjf63n0w3r2w4q6h_build_phases::forget_missing_installs()) {
+                throw ;
+            }
+            return resolve(invocation_context, workspace_graph, module);
+        }
+    } catch (const std::exception& e) {
+        workspace_graph.clear();
+        return served_t { .reply = std::format("error\n{}", e.what()), .handover_cli = std::nullopt, .handover_reason = {} };
+    }
+}
+
+[[noreturn]] void serve() {
+    const auto invocation_context = m03gagbhsp2drqq3gkop8pzfrm_workspace_graph::invocation_context();
+    const auto path = socket_path(invocation_context.artifact_root);
+    const auto address = socket_address(path);
+    if (!address) {
+        throw std::runtime_error(std::format("m03gagbhst621faiop1rztfkqp_builder_cli::serve: socket path '{}' is too long", path));
+    }
+
+    // A client that disconnects mid-build must not take the server down with it.
+    std::signal(SIGPIPE, SIG_IGN);
+
+    if (!m03gagbhsnusi43zogoacgj2ez_filesystem::exists(invocation_context.artifact_root)) {
+        m03gagbhsnusi43zogoacgj2ez_filesystem::create_directories(invocation_context.artifact_root);
+    }
+    if (m03gagbhsnusi43zogoacgj2ez_filesystem::exists(path)) {
+        fd_t probe(::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0));
+        if (probe.get() != -1 && connect_to(probe, *address)) {
+            throw std::runtime_error(std::format("m03gagbhst621faiop1rztfkqp_builder_cli::serve: a build server is already listening on '{}'", path));
+        }
+        m03gagbhsnusi43zogoacgj2ez_filesystem::remove(path);
+    }
+
+    fd_t listener(::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0));
+    if (listener.get() == -1) {
+        throw std::runtime_error(std::format("m03gagbhst621faiop1rztfkqp_builder_cli::serve: socket failed: {}", std::strerror(errno)));
+    }
+    if (::bind(listener.get(), reinterpret_cast<const sockaddr*>(&*address), sizeof(*address)) == -1) {
+        throw std::runtime_error(std::format("m03gagbhst621faiop1rztfkqp_builder_cli::serve: failed to bind '{}': {}", path, std::strerror(errno)));
+    }
+    if (::listen(listener.get(), SOMAXCONN) == -1) {
+        throw std::runtime_error(std::format("m03gagbhst621faiop1rztfkqp_builder_cli::serve: failed to listen on '{}': {}", path, std::strerror(errno)));
+    }
+
+    m03gagbhsp2drqq3gkop8pzfrm_workspace_graph::workspace_graph_t workspace_graph(
+        invocation_context.workspace_root,
+        invocation_context.artifact_root,
+        invocation_context.scratch_root
+    );
+
+    std::cout << std::format("build server listening on '{}'", path) << std::endl;
+
+    while (true) {
+        fd_t client(::accept4(listener.get(), nullptr, nullptr, SOCK_CLOEXEC));
+        if (client.get() == -1) {
+            if (errno == EINTR || errno == ECONNABORTED) {
+                continue ;
+            }
+            throw std::runtime_error(std::format("m03gagbhst621faiop1rztfkqp_builder_cli::serve: accept failed: {}", std::strerror(errno)));
+        }
+
+        const auto served = serve_request(invocation_context, workspace_graph, client);
+        send_all(client, served.reply);
+
+        if (served.handover_cli) {
+            std::cout << std::format("{}, restarting as '{}'", served.handover_reason, *served.handover_cli) << std::endl;
+            m03gagbhsnusi43zogoacgj2ez_filesystem::remove(path);
+            ::close(listener.get());
+            m03gagbhsvr0m5w15urj0o291m_process::exec(m03gagbhsvr0m5w15urj0o291m_process::command_t {
+                .args = { *served.handover_cli, std::string("--serve") }
+            });
+        }
+    }
+}
+
+} // namespace m03gagbhst621faiop1rztfkqp_builder_cli
@@ -0,0 +1,40 @@
+#ifndef M03GAGBHST621FAIOP1RZTFKQP_BUILDER_CLI_BUILD_SERVER_H
+# define M03GAGBHST621FAIOP1RZTFKQP_BUILDER_CLI_BUILD_SERVER_H
+
+# include "builder_cli.h"
+
+# include <m03gagbhsp2drqq3gkop8pzfrm_workspace_graph/workspace_graph.h>
+
+# include <optional>
+
+namespace m03gagbhst621faiop1rztfkqp_builder_cli {
+
+/**
+ * Build server socket file name under the artifact root.
+ */
+inline constexpr const char* BUILD_SERVER_SOCKET = "builder.sock";
+
+/**
+ * Serves ./cli requests on <artifact_root>/builder.sock, one at a time, until terminated.
+ *
+ * The workspace graph, completed phases, manifests and loaded builder plugins stay in memory between
+ * requests; plugins are never unloaded, so the server re-execs the seed CLI once it has loaded too many of
+ * them. Module versions come from source timestamps, so the graph is cleared and rediscovered only when a
+ * request finds it stale. Build output goes to the stdout and stderr the client passes along with its request.
+ */
+[[noreturn]] void serve();
+
+/**
+ * Asks the build server of the invocation's artifact root to install module's default CLI.
+ *
+ * Returns nullopt when no server is listening or it cannot serve this client, so the caller builds
+ * in-process. Throws when the server reports a build failure.
+ */
+std::optional<resolved_cli_t> request_from_build_server(
+    const m03gagbhsp2drqq3gkop8pzfrm_workspace_graph::invocation_context_t& invocation_context,
+    const m03gagbhsp2drqq3gkop8pzfrm_workspace_graph::module_name_t& module
+);
+
+} // namespace m03gagbhst621faiop1rztfkqp_builder_cli
+
+#endif // M03GAGBHST621FAIOP1RZTFKQP_BUILDER_CLI_BUILD_SERVER_H
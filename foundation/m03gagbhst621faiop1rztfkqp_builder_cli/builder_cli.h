@@ -1,6 +1,7 @@
 #ifndef M03GAGBHST621FAIOP1RZTFKQP_BUILDER_CLI_H
 # define M03GAGBHST621FAIOP1RZTFKQP_BUILDER_CLI_H
 
+# include <m03gagbhsnusi43zogoacgj2ez_filesystem/filesystem.h>
 # include <m03gagbhsp2drqq3gkop8pzfrm_workspace_graph/workspace_graph.h>
 # include <m03gagbhsvr0m5w15urj0o291m_process/process.h>
 
@@ -8,8 +9,28 @@
 
 namespace m03gagbhst621faiop1rztfkqp_builder_cli {
 
+/**
+ * Installed default CLI of a module and the directory it runs in.
+ */
+struct resolved_cli_t {
+    m03gagbhsnusi43zogoacgj2ez_filesystem::path_t cli;
+    m03gagbhsnusi43zogoacgj2ez_filesystem::path_t working_dir;
+};
+
+/**
+ * Returns whether the running executable is older than the bootstrap seed module and must hand over to the seed CLI.
+ */
+bool is_older_than_bootstrap_seed(m03gagbhsp2drqq3gkop8pzfrm_workspace_graph::workspace_graph_t& workspace_graph);
+
+/**
+ * Builds the default CLI of module, or of the bootstrap seed module, if needed.
+ */
+resolved_cli_t install_default_cli(m03gagbhsp2drqq3gkop8pzfrm_workspace_graph::module_t& module);
+
 /**
  * Builds a module's default CLI and replaces the current process with it.
+ *
+ * Asks a running build server first; see build_server.h.
  */
 [[noreturn]] void run(m03gagbhsp2drqq3gkop8pzfrm_workspace_graph::module_name_t module, const std::vector<m03gagbhsvr0m5w15urj0o291m_process::process_arg_t>& args);
 
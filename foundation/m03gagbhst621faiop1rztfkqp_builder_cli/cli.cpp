@@ -1,20 +1,56 @@
 #include <m03gagbhst621faiop1rztfkqp_builder_cli/builder_cli.h>
+#include <m03gagbhst621faiop1rztfkqp_builder_cli/build_server.h>
 
 #include <m03gagbhsp2drqq3gkop8pzfrm_workspace_graph/workspace_graph.h>
+#include <m03gagbhsujjf63n0w3r2w4q6h_build_phases/build_phases.h>
 #include <m03gagbhsvr0m5w15urj0o291m_process/process.h>
 
 #include <iostream>
 #include <exception>
 #include <format>
+#include <string>
+#include <string_view>
 #include <vector>
 
+static void usage(const char* program) {
+    std::cerr << std::format("usage: {} <module> [args...]", program) << std::endl;
+    std::cerr << std::format("       {} --serve", program) << std::endl;
+    std::cerr << std::format("       {} --gc [--keep-versions <n>] [--max-bytes <n>]", program) << std::endl;
+}
+
 int main(int argc, char** argv) {
     if (argc < 2) {
-        std::cerr << std::format("usage: {} <module> [args...]", argv[0]) << std::endl;
+        usage(argv[0]);
         return 1;
     }
 
     try {
+        if (std::string_view(argv[1]) == "--serve") {
+            m03gagbhst621faiop1rztfkqp_builder_cli::serve();
+        }
+
+        if (std::string_view(argv[1]) == "--gc") {
+            m03gagbhsujjf63n0w3r2w4q6h_build_phases::gc_policy_t policy;
+            for (int i = 2; i < argc; i += 2) {
+                const std::string_view option = argv[i];
+                if (i + 1 == argc || (option != "--keep-versions" && option != "--max-bytes")) {
+                    usage(argv[0]);
+                    return 1;
+                }
+
+                if (option == "--keep-versions") {
+                    policy.keep_versions = std::stoull(argv[i + 1]);
+                } else {
+                    policy.max_bytes = std::stoull(argv[i + 1]);
+                }
+            }
+
+            const auto invocation_context = m03gagbhsp2drqq3gkop8pzfrm_workspace_graph::invocation_context();
+            const auto result = m03gagbhsujjf63n0w3r2w4q6h_build_phases::collect_garbage(invocation_context, policy, true);
+            std::cout << std::format("removed {} directories and {} blobs, {} bytes", result->removed_dirs, result->removed_blobs, result->removed_bytes) << std::endl;
+            return 0;
+        }
+
         const auto module = m03gagbhsp2drqq3gkop8pzfrm_workspace_graph::module_name_t(argv[1]);
 
         std::vector<m03gagbhsvr0m5w15urj0o291m_process::process_arg_t> args;
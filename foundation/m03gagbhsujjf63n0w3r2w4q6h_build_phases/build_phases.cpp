@@ -5,17 +5,29 @@
 #include <m03gagbhsp2drqq3gkop8pzfrm_workspace_graph/workspace_graph.h>
 #include <m03gagbhsyhlx2pk5sdabbr1sx_signal_handler/signal_handler.h>
 #include <m03gagbhsx4j5z28bqkac3dhhh_shared_library/shared_library.h>
+#include <m03h2qrcln2fdgjro7rajbqejh_elf/elf.h>
 
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
 #include <format>
 #include <fstream>
+#include <iostream>
+#include <iterator>
 #include <memory>
+#include <sstream>
 #include <stdexcept>
 #include <string>
 #include <string_view>
 #include <type_traits>
+#include <unordered_map>
 #include <unordered_set>
 #include <utility>
 
+#include <fcntl.h>
+#include <sys/file.h>
+#include <unistd.h>
+
 #ifndef M03GAGBHSUJJF63N0W3R2W4Q6H_BUILD_PHASES_BOOTSTRAP_BUILDER_PLUGIN_PATH
 # error M03GAGBHSUJJF63N0W3R2W4Q6H_BUILD_PHASES_BOOTSTRAP_BUILDER_PLUGIN_PATH must be defined by bootstrap
 #endif
@@ -66,71 +78,1319 @@ static std::string cxx_string_literal(std::string_view value) {
     return result;
 }
 
-static m03gagbhsnusi43zogoacgj2ez_filesystem::relative_path_t module_library_relative_output_path(
-    const m03gagbhsp2drqq3gkop8pzfrm_workspace_graph::module_name_t& module_name,
-    m03gagbhsmhr0naw0zpccv4gaq_cxx_toolchain::library_type_t library_type
-) {
-    switch (library_type) {
-        case m03gagbhsmhr0naw0zpccv4gaq_cxx_toolchain::library_type_t::STATIC:
-            return m03gagbhsnusi43zogoacgj2ez_filesystem::relative_path_t(std::format("lib{}.a", module_name));
-        case m03gagbhsmhr0naw0zpccv4gaq_cxx_toolchain::library_type_t::SHARED:
-            return m03gagbhsnusi43zogoacgj2ez_filesystem::relative_path_t(std::format("lib{}.so", module_name));
-        default:
-            throw std::runtime_error(std::format("m03gagbhsujjf63n0w3r2w4q6h_build_phases::module_library_relative_output_path: unknown library_type {}", static_cast<std::underlying_type_t<m03gagbhsmhr0naw0zpccv4gaq_cxx_toolchain::library_type_t>>(library_type)));
-    }
-}
+static m03gagbhsnusi43zogoacgj2ez_filesystem::relative_path_t module_library_relative_output_path(
+    const m03gagbhsp2drqq3gkop8pzfrm_workspace_graph::module_name_t& module_name,
+    m03gagbhsmhr0naw0zpccv4gaq_cxx_toolchain::library_type_t library_type
+) {
+    switch (library_type) {
+        case m03gagbhsmhr0naw0zpccv4gaq_cxx_toolchain::library_type_t::STATIC:
+            return m03gagbhsnusi43zogoacgj2ez_filesystem::relative_path_t(std::format("lib{}.a", module_name));
+        case m03gagbhsmhr0naw0zpccv4gaq_cxx_toolchain::library_type_t::SHARED:
+            return m03gagbhsnusi43zogoacgj2ez_filesystem::relative_path_t(std::format("lib{}.so", module_name));
+        default:
+            throw std::runtime_error(std::format("m03gagbhsujjf63n0w3r2w4q6h_build_phases::module_library_relative_output_path: unknown library_type {}", static_cast<std::underlying_type_t<m03gagbhsmhr0naw0zpccv4gaq_cxx_toolchain::library_type_t>>(library_type)));
+    }
+}
+
+/**
+ * Identifies one phase install of one module version under one artifact root.
+ */
+struct phase_key_t {
+    std::string artifact_root;
+    std::string module_name;
+    uint64_t version;
+    std::string_view phase;
+    std::optional<m03gagbhsmhr0naw0zpccv4gaq_cxx_toolchain::library_type_t> library_type;
+
+    bool operator==(const phase_key_t& other) const = default;
+};
+
+struct phase_key_hash_t {
+    std::size_t operator()(const phase_key_t& phase_key) const {
+        std::size_t result = std::hash<std::string>()(phase_key.module_name);
+        result = result * 31 + std::hash<uint64_t>()(phase_key.version);
+        result = result * 31 + std::hash<std::string_view>()(phase_key.phase);
+        result = result * 31 + (phase_key.library_type ? static_cast<std::size_t>(*phase_key.library_type) + 1 : 0);
+        return result;
+    }
+};
+
+/**
+ * Phase install known to be complete in this process, mapped to its install_dir() or builder plugin path.
+ *
+ * Artifact directories are keyed by module version and a completed phase is never modified, so an
+ * entry stays valid for the lifetime of the process. Phases completed by another process are picked
+ * up from their manifest on the first lookup miss.
+ */
+static std::unordered_map<phase_key_t, m03gagbhsnusi43zogoacgj2ez_filesystem::path_t, phase_key_hash_t>& completed_phases() {
+    static std::unordered_map<phase_key_t, m03gagbhsnusi43zogoacgj2ez_filesystem::path_t, phase_key_hash_t> completed_phases;
+    return completed_phases;
+}
+
+/**
+ * Phase install currently running in this process; a second request for it is re-entry.
+ */
+static std::unordered_set<phase_key_t, phase_key_hash_t>& started_phases() {
+    static std::unordered_set<phase_key_t, phase_key_hash_t> started_phases;
+    return started_phases;
+}
+
+static phase_key_t phase_key(
+    const m03gagbhsp2drqq3gkop8pzfrm_workspace_graph::module_t& module,
+    std::string_view phase,
+    std::optional<m03gagbhsmhr0naw0zpccv4gaq_cxx_toolchain::library_type_t> library_type
+) {
+    return phase_key_t {
+        .artifact_root = module.workspace().graph().artifact_root().string(),
+        .module_name = module.name().string(),
+        .version = module.version().value,
+        .phase = phase,
+        .library_type = library_type
+    };
+}
+
+static constexpr std::string_view MANIFEST_HEADER = "builder-manifest 3";
+
+/**
+ * FNV-1a over a sequence of fields, so fingerprints are stable across processes and compilers.
+ */
+class fingerprint_t {
+public:
+    void mix(std::string_view field) {
+        for (const char c : field) {
+            m_value ^= static_cast<unsigned char>(c);
+            m_value *= 0x100000001b3ull;
+        }
+
+        // Field separator, so ("ab", "c") and ("a", "bc") differ.
+        m_value ^= 0xff;
+        m_value *= 0x100000001b3ull;
+    }
+
+    void mix(uint64_t field) {
+        mix(std::to_string(field));
+    }
+
+    uint64_t value() const {
+        return m_value;
+    }
+
+private:
+    uint64_t m_value = 0xcbf29ce484222325ull;
+};
+
+static m03gagbhsnusi43zogoacgj2ez_filesystem::path_t manifest_path(const m03gagbhsnusi43zogoacgj2ez_filesystem::path_t& install_dir) {
+    return install_dir + ".manifest";
+}
+
+/**
+ * Interface stub of a shared library install: "<abi hash> <relative path>" per installed shared library.
+ */
+static const m03gagbhsnusi43zogoacgj2ez_filesystem::relative_path_t ABI_STUB_NAME(".abi");
+
+/**
+ * Key of the link that produced a binary install's default CLI.
+ */
+static const m03gagbhsnusi43zogoacgj2ez_filesystem::relative_path_t LINK_KEY_NAME(".link");
+
+/**
+ * Builder metadata lives inside install_dir so the manifest records it and gc removes it with the install,
+ * but it is not an installed artifact.
+ */
+static bool is_install_metadata(const m03gagbhsnusi43zogoacgj2ez_filesystem::relative_path_t& relative_path) {
+    return relative_path == ABI_STUB_NAME || relative_path == LINK_KEY_NAME;
+}
+
+static m03gagbhsnusi43zogoacgj2ez_filesystem::path_t abi_stub_path(const m03gagbhsnusi43zogoacgj2ez_filesystem::path_t& install_dir) {
+    return install_dir / ABI_STUB_NAME;
+}
+
+static m03gagbhsnusi43zogoacgj2ez_filesystem::path_t link_key_path(const m03gagbhsnusi43zogoacgj2ez_filesystem::path_t& install_dir) {
+    return install_dir / LINK_KEY_NAME;
+}
+
+static std::unordered_map<std::string, manifest_t>& manifests() {
+    static std::unordered_map<std::string, manifest_t> manifests;
+    return manifests;
+}
+
+static manifest_t parse_manifest(const m03gagbhsnusi43zogoacgj2ez_filesystem::path_t& path) {
+    std::ifstream ifs(path.string(), std::ios::binary);
+    if (!ifs) {
+        throw std::runtime_error(std::format("m03gagbhsujjf63n0w3r2w4q6h_build_phases::read_manifest: failed to open manifest '{}'", path));
+    }
+
+    const auto invalid = [&](std::size_t line_number) {
+        return std::runtime_error(std::format("m03gagbhsujjf63n0w3r2w4q6h_build_phases::read_manifest: invalid manifest '{}' at line {}", path, line_number));
+    };
+
+    std::string line;
+    if (!std::getline(ifs, line) || line != MANIFEST_HEADER) {
+        throw invalid(1);
+    }
+
+    constexpr std::string_view fingerprint_prefix = "fingerprint ";
+    if (!std::getline(ifs, line) || !line.starts_with(fingerprint_prefix)) {
+        throw invalid(2);
+    }
+
+    manifest_t manifest {
+        .input_fingerprint = 0,
+        .entries = {}
+    };
+    try {
+        manifest.input_fingerprint = std::stoull(line.substr(fingerprint_prefix.size()));
+
+        for (std::size_t line_number = 3; std::getline(ifs, line); ++line_number) {
+            const auto size_end = line.find(' ');
+            const auto hash_end = size_end == std::string::npos ? std::string::npos : line.find(' ', size_end + 1);
+            if (hash_end == std::string::npos || hash_end + 1 == line.size()) {
+                throw invalid(line_number);
+            }
+
+            manifest.entries.push_back(manifest_entry_t {
+                .relative_path = m03gagbhsnusi43zogoacgj2ez_filesystem::relative_path_t(line.substr(hash_end + 1)),
+                .size = std::stoull(line.substr(0, size_end)),
+                .content_hash = std::stoull(line.substr(size_end + 1, hash_end - size_end - 1))
+            });
+        }
+    } catch (const std::logic_error&) {
+        throw invalid(manifest.entries.size() + 3);
+    }
+
+    return manifest;
+}
+
+const manifest_t& read_manifest(const m03gagbhsnusi43zogoacgj2ez_filesystem::path_t& install_dir) {
+    auto it = manifests().find(install_dir.string());
+    if (it == manifests().end()) {
+        it = manifests().emplace(install_dir.string(), parse_manifest(manifest_path(install_dir))).first;
+    }
+
+    return it->second;
+}
+
+/**
+ * Size and content hash of files published through the blob store, so write_manifest() need not read them again.
+ */
+static std::unordered_map<std::string, std::pair<std::uintmax_t, uint64_t>>& installed_hashes() {
+    static std::unordered_map<std::string, std::pair<std::uintmax_t, uint64_t>> installed_hashes;
+    return installed_hashes;
+}
+
+static void forget_installed_hashes(const m03gagbhsnusi43zogoacgj2ez_filesystem::path_t& install_dir) {
+    std::erase_if(installed_hashes(), [&](const auto& installed_hash) {
+        return install_dir.is_child(m03gagbhsnusi43zogoacgj2ez_filesystem::path_t(installed_hash.first));
+    });
+}
+
+/**
+ * Records every file under install_dir, then publishes the manifest with a rename so readers never see a partial one.
+ */
+static void write_manifest(const m03gagbhsnusi43zogoacgj2ez_filesystem::path_t& install_dir, uint64_t fingerprint) {
+    manifest_t manifest {
+        .input_fingerprint = fingerprint,
+        .entries = {}
+    };
+    for (const auto& installed : m03gagbhsnusi43zogoacgj2ez_filesystem::find(install_dir, !m03gagbhsnusi43zogoacgj2ez_filesystem::find_include_predicate_t::is_dir, m03gagbhsnusi43zogoacgj2ez_filesystem::find_descend_predicate_t::descend_all)) {
+        if (installed.relative_path().string().find('\n') != std::string::npos) {
+            throw std::runtime_error(std::format("m03gagbhsujjf63n0w3r2w4q6h_build_phases::write_manifest: installed path '{}' contains a newline", installed.path()));
+        }
+
+        const auto installed_path = installed.path();
+        if (const auto it = installed_hashes().find(installed_path.string()); it != installed_hashes().end()) {
+            manifest.entries.push_back(manifest_entry_t {
+                .relative_path = installed.relative_path(),
+                .size = it->second.first,
+                .content_hash = it->second.second
+            });
+            installed_hashes().erase(it);
+            continue ;
+        }
+
+        manifest.entries.push_back(manifest_entry_t {
+            .relative_path = installed.relative_path(),
+            .size = m03gagbhsnusi43zogoacgj2ez_filesystem::file_size(installed_path),
+            .content_hash = m03gagbhsnusi43zogoacgj2ez_filesystem::content_hash(installed_path)
+        });
+    }
+    std::sort(manifest.entries.begin(), manifest.entries.end(), [](const manifest_entry_t& a, const manifest_entry_t& b) {
+        return a.relative_path.string() < b.relative_path.string();
+    });
+
+    const auto path = manifest_path(install_dir);
+    const auto tmp_path = path + std::format(".{}_tmp", ::getpid());
+    {
+        std::ofstream ofs(tmp_path.string(), std::ios::binary | std::ios::trunc);
+        if (!ofs) {
+            throw std::runtime_error(std::format("m03gagbhsujjf63n0w3r2w4q6h_build_phases::write_manifest: failed to open file '{}'", tmp_path));
+        }
+
+        ofs << MANIFEST_HEADER << "\n" << std::format("fingerprint {}\n", manifest.input_fingerprint);
+        for (const auto& entry : manifest.entries) {
+            ofs << std::format("{} {} {}\n", entry.size, entry.content_hash, entry.relative_path.string());
+        }
+        if (!ofs.flush()) {
+            throw std::runtime_error(std::format("m03gagbhsujjf63n0w3r2w4q6h_build_phases::write_manifest: failed to write file '{}'", tmp_path));
+        }
+    }
+    m03gagbhsnusi43zogoacgj2ez_filesystem::rename_replace(tmp_path, path);
+
+    manifests().insert_or_assign(install_dir.string(), std::move(manifest));
+}
+
+/**
+ * Returns whether every manifest entry still has its recorded size and content hash.
+ */
+static bool manifest_contents_match(const m03gagbhsnusi43zogoacgj2ez_filesystem::path_t& install_dir, const manifest_t& manifest) {
+    for (const auto& entry : manifest.entries) {
+        const auto path = install_dir / entry.relative_path;
+        if (
+            !m03gagbhsnusi43zogoacgj2ez_filesystem::is_regular_file(path) ||
+            m03gagbhsnusi43zogoacgj2ez_filesystem::file_size(path) != entry.size ||
+            m03gagbhsnusi43zogoacgj2ez_filesystem::content_hash(path) != entry.content_hash
+        ) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/**
+ * Returns whether install_dir has a manifest written for fingerprint. One this version cannot read or one from
+ * other inputs is removed, and so is one whose files no longer match it when verify_contents is set, which only
+ * source snapshots need because only they may hard link workspace files.
+ */
+static bool has_manifest(const m03gagbhsnusi43zogoacgj2ez_filesystem::path_t& install_dir, uint64_t fingerprint, bool verify_contents) {
+    const auto path = manifest_path(install_dir);
+    if (!m03gagbhsnusi43zogoacgj2ez_filesystem::exists(path)) {
+        return false;
+    }
+
+    const manifest_t* manifest = nullptr;
+    try {
+        manifest = &read_manifest(install_dir);
+    } catch (const std::runtime_error&) {
+        // Written by an older builder, or left truncated; the install is rebuilt either way.
+    }
+    if (manifest && manifest->input_fingerprint == fingerprint && (!verify_contents || manifest_contents_match(install_dir, *manifest))) {
+        return true;
+    }
+
+    manifests().erase(install_dir.string());
+    m03gagbhsnusi43zogoacgj2ez_filesystem::remove(path);
+    return false;
+}
+
+static std::vector<m03gagbhsnusi43zogoacgj2ez_filesystem::path_t> installed_files(const m03gagbhsnusi43zogoacgj2ez_filesystem::path_t& install_dir) {
+    const auto& manifest = read_manifest(install_dir);
+
+    std::vector<m03gagbhsnusi43zogoacgj2ez_filesystem::path_t> result;
+    result.reserve(manifest.entries.size());
+    for (const auto& entry : manifest.entries) {
+        if (!is_install_metadata(entry.relative_path)) {
+            result.push_back(install_dir / entry.relative_path);
+        }
+    }
+
+    return result;
+}
+
+static m03gagbhsmhr0naw0zpccv4gaq_cxx_toolchain::link_inputs_t binary_link_inputs(
+    const m03gagbhsp2drqq3gkop8pzfrm_workspace_graph::module_t& module,
+    build_config_t build_config
+) {
+    bool static_libraries = false;
+    switch (build_config.library_type) {
+        case m03gagbhsmhr0naw0zpccv4gaq_cxx_toolchain::library_type_t::STATIC: static_libraries = true; break ;
+        case m03gagbhsmhr0naw0zpccv4gaq_cxx_toolchain::library_type_t::SHARED: break ;
+        default: throw std::runtime_error(std::format("m03gagbhsujjf63n0w3r2w4q6h_build_phases::binary_link_inputs: unknown library_type {}", static_cast<std::underlying_type_t<m03gagbhsmhr0naw0zpccv4gaq_cxx_toolchain::library_type_t>>(build_config.library_type)));
+    }
+
+    const auto closure_groups = module.closure_groups();
+
+    m03gagbhsmhr0naw0zpccv4gaq_cxx_toolchain::link_inputs_t result;
+    for (auto group_it = closure_groups.rbegin(); group_it != closure_groups.rend(); ++group_it) {
+        m03gagbhsmhr0naw0zpccv4gaq_cxx_toolchain::link_input_group_t group {
+            .libraries = {},
+            .static_library_group = false
+        };
+
+        for (auto module_it = group_it->rbegin(); module_it != group_it->rend(); ++module_it) {
+            const auto phase = phase_base_t::make(**module_it, build_config);
+            const auto libraries = phase->install<library_phase_t>();
+            for (const auto& library : installed_files(libraries.root())) {
+                group.libraries.push_back(library);
+            }
+        }
+
+        if (!group.libraries.empty()) {
+            group.static_library_group = static_libraries && 1 < group.libraries.size();
+            result.groups.push_back(group);
+        }
+    }
+
+    return result;
+}
+
+/**
+ * How install_as() publishes regular files, selected per artifact root by <artifact_root>/install_strategy.
+ */
+enum class install_strategy_t {
+    /**
+     * Reflink; otherwise hard link outputs that already live under the artifact root; otherwise copy. The default.
+     */
+    AUTO,
+
+    /**
+     * Reflink; otherwise copy. Installed files never share an inode with their source.
+     */
+    REFLINK,
+
+    /**
+     * Always copy bytes.
+     */
+    COPY
+};
+
+static constexpr const char* INSTALL_STRATEGY_FILE = "install_strategy";
+
+struct install_settings_t {
+    install_strategy_t strategy;
+    m03gagbhsnusi43zogoacgj2ez_filesystem::path_t canonical_artifact_root;
+    m03gagbhsnusi43zogoacgj2ez_filesystem::path_t canonical_scratch_root;
+
+    /**
+     * Whether path is a build output or part of a completed install rather than a workspace file.
+     */
+    bool is_built(const m03gagbhsnusi43zogoacgj2ez_filesystem::path_t& path) const {
+        return canonical_artifact_root.is_child(path) || canonical_scratch_root.is_child(path);
+    }
+};
+
+/**
+ * Called once a phase build_dir() exists, so both roots can be resolved.
+ */
+static const install_settings_t& install_settings(const m03gagbhsp2drqq3gkop8pzfrm_workspace_graph::workspace_graph_t& workspace_graph) {
+    static std::unordered_map<std::string, install_settings_t> install_settings;
+    const auto& artifact_root = workspace_graph.artifact_root();
+    if (const auto it = install_settings.find(artifact_root.string()); it != install_settings.end()) {
+        return it->second;
+    }
+
+    install_strategy_t strategy = install_strategy_t::AUTO;
+    const auto strategy_path = artifact_root / m03gagbhsnusi43zogoacgj2ez_filesystem::relative_path_t(INSTALL_STRATEGY_FILE);
+    if (m03gagbhsnusi43zogoacgj2ez_filesystem::exists(strategy_path)) {
+        std::ifstream ifs(strategy_path.string());
+        std::string value;
+        if (!(ifs >> value)) {
+            throw std::runtime_error(std::format("m03gagbhsujjf63n0w3r2w4q6h_build_phases::install_settings: failed to read install strategy '{}'", strategy_path));
+        }
+
+        if (value == "auto") {
+            strategy = install_strategy_t::AUTO;
+        } else if (value == "reflink") {
+            strategy = install_strategy_t::REFLINK;
+        } else if (value == "copy") {
+            strategy = install_strategy_t::COPY;
+        } else {
+            throw std::runtime_error(std::format("m03gagbhsujjf63n0w3r2w4q6h_build_phases::install_settings: unknown install strategy '{}' in '{}', expected auto, reflink or copy", value, strategy_path));
+        }
+    }
+
+    return install_settings.emplace(artifact_root.string(), install_settings_t {
+        .strategy = strategy,
+        .canonical_artifact_root = m03gagbhsnusi43zogoacgj2ez_filesystem::canonical(artifact_root),
+        .canonical_scratch_root = m03gagbhsnusi43zogoacgj2ez_filesystem::canonical(workspace_graph.scratch_root())
+    }).first->second;
+}
+
+static constexpr const char* BLOB_STORE_DIR = "blobs";
+static constexpr const char* DEFAULT_CLI_DIR = "default_cli";
+static constexpr const char* INCLUDE_TREE_DIR = "include_trees";
+
+/**
+ * Content-addressed file shared by every install of the same bytes and permissions:
+ * <artifact_root>/blobs/<hash % 256>/<hash>_<size>_<mode>.
+ *
+ * Installs hard link the blob, so its link count beyond one counts the installs that still use it. Blobs are
+ * read-only, so no in-place write through an install reaches the other installs sharing it.
+ */
+static m03gagbhsnusi43zogoacgj2ez_filesystem::path_t blob_path(
+    const m03gagbhsnusi43zogoacgj2ez_filesystem::path_t& artifact_root,
+    uint64_t content_hash,
+    std::uintmax_t size,
+    std::filesystem::perms permissions
+) {
+    return artifact_root
+        / m03gagbhsnusi43zogoacgj2ez_filesystem::relative_path_t(BLOB_STORE_DIR)
+        / m03gagbhsnusi43zogoacgj2ez_filesystem::relative_path_t(std::to_string(content_hash % 256))
+        / m03gagbhsnusi43zogoacgj2ez_filesystem::relative_path_t(std::format("{}_{}_{}", content_hash, size, static_cast<unsigned>(permissions)));
+}
+
+/**
+ * Hard links installed_artifact to the blob holding source's bytes, adding a copy of source first if needed.
+ *
+ * Returns false when the filesystem cannot hard link the blob, or when the blob's bytes differ from source's,
+ * as they would on a hash collision.
+ */
+static bool install_blob(
+    const m03gagbhsnusi43zogoacgj2ez_filesystem::path_t& source,
+    const m03gagbhsnusi43zogoacgj2ez_filesystem::path_t& installed_artifact,
+    const m03gagbhsnusi43zogoacgj2ez_filesystem::path_t& artifact_root
+) {
+    const auto size = m03gagbhsnusi43zogoacgj2ez_filesystem::file_size(source);
+    const auto content_hash = m03gagbhsnusi43zogoacgj2ez_filesystem::content_hash(source);
+    const auto blob = blob_path(artifact_root, content_hash, size, m03gagbhsnusi43zogoacgj2ez_filesystem::permissions(source));
+
+    if (m03gagbhsnusi43zogoacgj2ez_filesystem::exists(blob)) {
+        if (!m03gagbhsnusi43zogoacgj2ez_filesystem::same_contents(source, blob)) {
+            return false;
+        }
+
+        // The blob may predate this build, and an installed CLI must not look older than the modules it was built from.
+        m03gagbhsnusi43zogoacgj2ez_filesystem::touch(blob);
+    } else {
+        // Never the source itself: build outputs stay in build_dir() and may be rewritten there, and snapshots share
+        // workspace files. Concurrent writers of the same blob race harmlessly through the rename.
+        const auto blob_tmp = blob + std::format(".{}_tmp", ::getpid());
+        m03gagbhsnusi43zogoacgj2ez_filesystem::copy(source, blob_tmp);
+        m03gagbhsnusi43zogoacgj2ez_filesystem::permissions(
+            blob_tmp,
+            m03gagbhsnusi43zogoacgj2ez_filesystem::permissions(blob_tmp) & ~(std::filesystem::perms::owner_write | std::filesystem::perms::group_write | std::filesystem::perms::others_write)
+        );
+        m03gagbhsnusi43zogoacgj2ez_filesystem::rename_replace(blob_tmp, blob);
+    }
+
+    if (!m03gagbhsnusi43zogoacgj2ez_filesystem::create_hard_link(blob, installed_artifact)) {
+        return false;
+    }
+
+    installed_hashes().insert_or_assign(installed_artifact.string(), std::make_pair(size, content_hash));
+    return true;
+}
+
+/**
+ * Publishes path at installed_artifact following the artifact root's install strategy. Directories are always copied.
+ *
+ * Without reflinks, regular files go through the blob store, except that a snapshot hard links workspace files
+ * directly because its manifest is verified before reuse.
+ */
+static void install_file(
+    const m03gagbhsnusi43zogoacgj2ez_filesystem::path_t& path,
+    const m03gagbhsnusi43zogoacgj2ez_filesystem::path_t& installed_artifact,
+    const m03gagbhsp2drqq3gkop8pzfrm_workspace_graph::workspace_graph_t& workspace_graph,
+    bool snapshot
+) {
+    const auto& settings = install_settings(workspace_graph);
+    if (settings.strategy != install_strategy_t::COPY && m03gagbhsnusi43zogoacgj2ez_filesystem::is_regular_file(path)) {
+        const auto source = m03gagbhsnusi43zogoacgj2ez_filesystem::canonical(path);
+        if (m03gagbhsnusi43zogoacgj2ez_filesystem::clone_file(source, installed_artifact)) {
+            return ;
+        }
+
+        if (settings.strategy == install_strategy_t::AUTO) {
+            if (snapshot && !settings.is_built(source)) {
+                if (m03gagbhsnusi43zogoacgj2ez_filesystem::create_hard_link(source, installed_artifact)) {
+                    return ;
+                }
+            } else if (install_blob(source, installed_artifact, workspace_graph.artifact_root())) {
+                return ;
+            }
+        }
+    }
+
+    m03gagbhsnusi43zogoacgj2ez_filesystem::copy(path, installed_artifact);
+}
+
+/**
+ * Builder plugin cache entry: <artifact_root>/<module>/builder/<plugin key>.
+ *
+ * Lives outside the versioned artifact_dir() so a new module version with the same builder.cpp and builder
+ * dependency outputs reuses the plugin.
+ */
+static m03gagbhsnusi43zogoacgj2ez_filesystem::path_t builder_dir(const m03gagbhsp2drqq3gkop8pzfrm_workspace_graph::module_t& module, uint64_t plugin_key) {
+    return module.artifact_base_dir() / m03gagbhsnusi43zogoacgj2ez_filesystem::relative_path_t("builder") / m03gagbhsnusi43zogoacgj2ez_filesystem::relative_path_t(std::to_string(plugin_key));
+}
+
+/**
+ * Builder plugin objects: <scratch_root>/<module>/builder/<plugin key>/build.
+ */
+static m03gagbhsnusi43zogoacgj2ez_filesystem::path_t builder_build_dir(const m03gagbhsp2drqq3gkop8pzfrm_workspace_graph::module_t& module, uint64_t plugin_key) {
+    return module.workspace().graph().scratch_root()
+        / m03gagbhsnusi43zogoacgj2ez_filesystem::relative_path_t(module.name().string())
+        / m03gagbhsnusi43zogoacgj2ez_filesystem::relative_path_t("builder")
+        / m03gagbhsnusi43zogoacgj2ez_filesystem::relative_path_t(std::to_string(plugin_key))
+        / m03gagbhsnusi43zogoacgj2ez_filesystem::relative_path_t("build");
+}
+
+/**
+ * Whether build directories live apart from the artifact root, and are removed once their phase completes.
+ */
+static bool has_separate_scratch_root(const m03gagbhsp2drqq3gkop8pzfrm_workspace_graph::workspace_graph_t& workspace_graph) {
+    return workspace_graph.scratch_root() != workspace_graph.artifact_root();
+}
+
+/**
+ * Hashes what the compiled plugin depends on: builder.cpp content, the installed headers it can include, and
+ * the libraries it links. Library paths are part of the key because the plugin records them for the loader.
+ */
+static uint64_t builder_plugin_key(
+    const m03gagbhsp2drqq3gkop8pzfrm_workspace_graph::module_t& module,
+    const std::vector<m03gagbhsnusi43zogoacgj2ez_filesystem::path_t>& include_dirs,
+    const std::vector<m03gagbhsnusi43zogoacgj2ez_filesystem::path_t>& library_dirs
+) {
+    fingerprint_t fingerprint;
+    fingerprint.mix(m03gagbhsnusi43zogoacgj2ez_filesystem::content_hash(module.source_dir() / m03gagbhsnusi43zogoacgj2ez_filesystem::relative_path_t(m03gagbhsp2drqq3gkop8pzfrm_workspace_graph::BUILDER_CPP)));
+
+    for (const auto& include_dir : include_dirs) {
+        for (const auto& entry : read_manifest(include_dir).entries) {
+            fingerprint.mix(entry.relative_path.string());
+            fingerprint.mix(entry.size);
+            fingerprint.mix(entry.content_hash);
+        }
+    }
+
+    for (const auto& library_dir : library_dirs) {
+        for (const auto& entry : read_manifest(library_dir).entries) {
+            fingerprint.mix((library_dir / entry.relative_path).string());
+            fingerprint.mix(entry.content_hash);
+        }
+    }
+
+    return fingerprint.value();
+}
+
+/**
+ * Lists the installs an include tree was built from, one per line, next to the tree as <key>.inputs.
+ */
+static m03gagbhsnusi43zogoacgj2ez_filesystem::path_t include_tree_inputs_path(const m03gagbhsnusi43zogoacgj2ez_filesystem::path_t& cache_dir, std::string_view key) {
+    return cache_dir / m03gagbhsnusi43zogoacgj2ez_filesystem::relative_path_t(std::format("{}.inputs", key));
+}
+
+/**
+ * Publishes the inputs of an include tree before the tree itself, so collect_garbage() can drop the tree
+ * with the first of its installs it collects.
+ */
+static void write_include_tree_inputs(
+    const m03gagbhsnusi43zogoacgj2ez_filesystem::path_t& cache_dir,
+    std::string_view key,
+    const std::vector<m03gagbhsnusi43zogoacgj2ez_filesystem::path_t>& install_dirs
+) {
+    if (!m03gagbhsnusi43zogoacgj2ez_filesystem::exists(cache_dir)) {
+        m03gagbhsnusi43zogoacgj2ez_filesystem::create_directories(cache_dir);
+    }
+
+    const auto path = include_tree_inputs_path(cache_dir, key);
+    const auto tmp_path = path + std::format(".{}_tmp", ::getpid());
+    {
+        std::ofstream ofs(tmp_path.string(), std::ios::binary | std::ios::trunc);
+        if (!ofs) {
+            throw std::runtime_error(std::format("m03gagbhsujjf63n0w3r2w4q6h_build_phases::write_include_tree_inputs: failed to open file '{}'", tmp_path));
+        }
+
+        for (const auto& install_dir : install_dirs) {
+            ofs << install_dir.string() << "\n";
+        }
+        if (!ofs.flush()) {
+            throw std::runtime_error(std::format("m03gagbhsujjf63n0w3r2w4q6h_build_phases::write_include_tree_inputs: failed to write file '{}'", tmp_path));
+        }
+    }
+    m03gagbhsnusi43zogoacgj2ez_filesystem::rename_replace(tmp_path, path);
+}
+
+/**
+ * Merges include_dirs into one root, <scratch_root>/include_trees/<key>, so a compile searches one -I directory.
+ *
+ * The first include dir that publishes a relative path wins, as it would in -I order. Files are hard linked from
+ * the installs, or symlinked across filesystems. The key hashes the installs and their manifests, so a tree is
+ * built once per closure and reused until collect_garbage() collects one of include_dirs.
+ */
+static std::vector<m03gagbhsnusi43zogoacgj2ez_filesystem::path_t> include_tree(
+    const m03gagbhsp2drqq3gkop8pzfrm_workspace_graph::workspace_graph_t& workspace_graph,
+    const std::vector<m03gagbhsnusi43zogoacgj2ez_filesystem::path_t>& include_dirs
+) {
+    if (include_dirs.size() <= 1) {
+        return include_dirs;
+    }
+
+    fingerprint_t fingerprint;
+    for (const auto& include_dir : include_dirs) {
+        fingerprint.mix(include_dir.string());
+        for (const auto& entry : read_manifest(include_dir).entries) {
+            fingerprint.mix(entry.relative_path.string());
+            fingerprint.mix(entry.content_hash);
+        }
+    }
+
+    const auto cache_dir = workspace_graph.scratch_root() / m03gagbhsnusi43zogoacgj2ez_filesystem::relative_path_t(INCLUDE_TREE_DIR);
+    const auto key = std::to_string(fingerprint.value());
+    const auto result = cache_dir / m03gagbhsnusi43zogoacgj2ez_filesystem::relative_path_t(key);
+    if (m03gagbhsnusi43zogoacgj2ez_filesystem::exists(result)) {
+        return { result };
+    }
+
+    write_include_tree_inputs(cache_dir, key, include_dirs);
+
+    const auto result_tmp = result + std::format(".{}_tmp", ::getpid());
+    if (m03gagbhsnusi43zogoacgj2ez_filesystem::exists(result_tmp)) {
+        m03gagbhsnusi43zogoacgj2ez_filesystem::remove_all(result_tmp);
+    }
+    m03gagbhsnusi43zogoacgj2ez_filesystem::create_directories(result_tmp);
+
+    for (const auto& include_dir : include_dirs) {
+        for (const auto& entry : read_manifest(include_dir).entries) {
+            const auto header = include_dir / entry.relative_path;
+            const auto linked_header = result_tmp / entry.relative_path;
+            if (m03gagbhsnusi43zogoacgj2ez_filesystem::exists(linked_header) || m03gagbhsnusi43zogoacgj2ez_filesystem::is_directory(header)) {
+                continue ;
+            }
+
+            if (!m03gagbhsnusi43zogoacgj2ez_filesystem::create_hard_link(header, linked_header)) {
+                m03gagbhsnusi43zogoacgj2ez_filesystem::create_symlink(header, linked_header);
+            }
+        }
+    }
+
+    // Another build of the same closure may have published the tree first; both are identical.
+    try {
+        m03gagbhsnusi43zogoacgj2ez_filesystem::rename_strict(result_tmp, result);
+    } catch (const std::exception&) {
+        if (!m03gagbhsnusi43zogoacgj2ez_filesystem::exists(result)) {
+            throw ;
+        }
+        m03gagbhsnusi43zogoacgj2ez_filesystem::remove_all(result_tmp);
+    }
+
+    return { result };
+}
+
+/**
+ * Hashes what compiling source_files depends on: defines, the installed headers they can include, and each source
+ * with the snapshot it comes from. Equal for both library types when their inputs are, so their objects are shared.
+ */
+static uint64_t object_key(
+    const std::vector<m03gagbhsnusi43zogoacgj2ez_filesystem::path_t>& include_dirs,
+    const std::vector<m03gagbhsnusi43zogoacgj2ez_filesystem::rooted_path_t>& source_files,
+    const std::vector<m03gagbhsmhr0naw0zpccv4gaq_cxx_toolchain::define_t>& defines
+) {
+    fingerprint_t fingerprint;
+    for (const auto& define : defines) {
+        fingerprint.mix(define.key());
+        fingerprint.mix(define.value());
+    }
+
+    for (const auto& include_dir : include_dirs) {
+        for (const auto& entry : read_manifest(include_dir).entries) {
+            fingerprint.mix(entry.relative_path.string());
+            fingerprint.mix(entry.content_hash);
+        }
+    }
+
+    // Sources may include siblings from their snapshot; generated sources outside an install key by path.
+    std::unordered_set<std::string> source_roots;
+    for (const auto& source_file : source_files) {
+        fingerprint.mix(source_file.relative_path().string());
+        fingerprint.mix(m03gagbhsnusi43zogoacgj2ez_filesystem::content_hash(source_file.path()));
+
+        if (!source_roots.insert(source_file.root().string()).second) {
+            continue ;
+        }
+
+        if (m03gagbhsnusi43zogoacgj2ez_filesystem::exists(manifest_path(source_file.root()))) {
+            for (const auto& entry : read_manifest(source_file.root()).entries) {
+                fingerprint.mix(entry.relative_path.string());
+                fingerprint.mix(entry.content_hash);
+            }
+        } else {
+            fingerprint.mix(source_file.root().string());
+        }
+    }
+
+    return fingerprint.value();
+}
+
+/**
+ * Position-independent objects shared by both library types: <scratch dir>/<phase>/build/objects/<objects key>,
+ * where objects_key is object_key() of the same inputs.
+ */
+static std::vector<m03gagbhsnusi43zogoacgj2ez_filesystem::path_t> build_shared_objects(
+    const m03gagbhsp2drqq3gkop8pzfrm_workspace_graph::module_t& module,
+    std::string_view phase_name,
+    const std::vector<m03gagbhsnusi43zogoacgj2ez_filesystem::path_t>& include_dirs,
+    const std::vector<m03gagbhsnusi43zogoacgj2ez_filesystem::rooted_path_t>& source_files,
+    const std::vector<m03gagbhsmhr0naw0zpccv4gaq_cxx_toolchain::define_t>& defines,
+    uint64_t objects_key
+) {
+    const auto object_dir = module.artifact_scratch_dir()
+        / m03gagbhsnusi43zogoacgj2ez_filesystem::relative_path_t(std::string(phase_name))
+        / m03gagbhsnusi43zogoacgj2ez_filesystem::relative_path_t("build")
+        / m03gagbhsnusi43zogoacgj2ez_filesystem::relative_path_t("objects")
+        / m03gagbhsnusi43zogoacgj2ez_filesystem::relative_path_t(std::to_string(objects_key));
+
+    return m03gagbhsmhr0naw0zpccv4gaq_cxx_toolchain::build_objects(
+        object_dir,
+        include_tree(module.workspace().graph(), include_dirs),
+        source_files,
+        defines
+    );
+}
+
+bool forget_missing_installs() {
+    const auto completed_count = completed_phases().size();
+    const auto manifest_count = manifests().size();
+
+    std::erase_if(completed_phases(), [](const auto& completed_phase) {
+        return !m03gagbhsnusi43zogoacgj2ez_filesystem::exists(completed_phase.second);
+    });
+    std::erase_if(manifests(), [](const auto& manifest) {
+        return !m03gagbhsnusi43zogoacgj2ez_filesystem::exists(manifest_path(m03gagbhsnusi43zogoacgj2ez_filesystem::path_t(manifest.first)));
+    });
+
+    return completed_phases().size() != completed_count || manifests().size() != manifest_count;
+}
+
+/**
+ * Paths of the builder plugins loaded by install(), which stay mapped until the process exits.
+ */
+static std::unordered_set<std::string>& loaded_builder_plugins() {
+    static std::unordered_set<std::string> loaded_builder_plugins;
+    return loaded_builder_plugins;
+}
+
+std::size_t loaded_builder_plugin_count() {
+    return loaded_builder_plugins().size();
+}
+
+static constexpr const char* ARTIFACT_LOCK_FILE = "artifacts.lock";
+static constexpr const char* GC_POLICY_FILE = "gc_policy";
+
+struct install_lock_state_t {
+    int fd = -1;
+    std::size_t depth = 0;
+};
+
+static std::unordered_map<std::string, install_lock_state_t>& install_locks() {
+    static std::unordered_map<std::string, install_lock_state_t> install_locks;
+    return install_locks;
+}
+
+/**
+ * Opens lock_path, creating it, and flocks it with operation. Returns -1 when LOCK_NB is set and the lock is held.
+ */
+static int lock_file(const m03gagbhsnusi43zogoacgj2ez_filesystem::path_t& lock_path, int operation) {
+    const int fd = ::open(lock_path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (fd == -1) {
+        throw std::runtime_error(std::format("m03gagbhsujjf63n0w3r2w4q6h_build_phases::lock_file: failed to open '{}': {}", lock_path, std::strerror(errno)));
+    }
+
+    int result;
+    do {
+        result = ::flock(fd, operation);
+    } while (result == -1 && errno == EINTR);
+    if (result == -1) {
+        const int error = errno;
+        ::close(fd);
+        if (error == EWOULDBLOCK) {
+            return -1;
+        }
+        throw std::runtime_error(std::format("m03gagbhsujjf63n0w3r2w4q6h_build_phases::lock_file: failed to lock '{}': {}", lock_path, std::strerror(error)));
+    }
+
+    return fd;
+}
+
+static int lock_artifact_root(const m03gagbhsnusi43zogoacgj2ez_filesystem::path_t& artifact_root, int operation) {
+    if (!m03gagbhsnusi43zogoacgj2ez_filesystem::exists(artifact_root)) {
+        m03gagbhsnusi43zogoacgj2ez_filesystem::create_directories(artifact_root);
+    }
+
+    return lock_file(artifact_root / m03gagbhsnusi43zogoacgj2ez_filesystem::relative_path_t(ARTIFACT_LOCK_FILE), operation);
+}
+
+/**
+ * Shared lock on <artifact_root>/artifacts.lock held while this process builds into the artifact root.
+ *
+ * collect_garbage() takes the lock exclusively. Nested builds share the outermost acquisition.
+ */
+class scoped_install_lock_t {
+public:
+    explicit scoped_install_lock_t(const m03gagbhsnusi43zogoacgj2ez_filesystem::path_t& artifact_root):
+        m_state(install_locks()[artifact_root.string()])
+    {
+        if (m_state.depth == 0) {
+            m_state.fd = lock_artifact_root(artifact_root, LOCK_SH);
+        }
+        ++m_state.depth;
+    }
+
+    ~scoped_install_lock_t() {
+        if (--m_state.depth == 0) {
+            ::close(m_state.fd);
+            m_state.fd = -1;
+        }
+    }
+
+    scoped_install_lock_t(const scoped_install_lock_t&) = delete;
+    scoped_install_lock_t& operator=(const scoped_install_lock_t&) = delete;
+
+private:
+    install_lock_state_t& m_state;
+};
+
+/**
+ * Exclusive lock on <install_dir>.lock held while this process builds install_dir.
+ *
+ * Builders share the artifacts lock, so this is what keeps two processes from removing and rebuilding the same
+ * install. A phase only waits on the phases it depends on, which are acyclic, so waiting processes cannot deadlock.
+ */
+class scoped_phase_lock_t {
+public:
+    explicit scoped_phase_lock_t(const m03gagbhsnusi43zogoacgj2ez_filesystem::path_t& install_dir) {
+        const auto lock_dir = install_dir.parent();
+        if (!m03gagbhsnusi43zogoacgj2ez_filesystem::exists(lock_dir)) {
+            m03gagbhsnusi43zogoacgj2ez_filesystem::create_directories(lock_dir);
+        }
+
+        m_fd = lock_file(install_dir + ".lock", LOCK_EX);
+    }
+
+    ~scoped_phase_lock_t() {
+        ::close(m_fd);
+    }
+
+    scoped_phase_lock_t(const scoped_phase_lock_t&) = delete;
+    scoped_phase_lock_t& operator=(const scoped_phase_lock_t&) = delete;
+
+private:
+    int m_fd;
+};
+
+static bool& installed_since_gc() {
+    static bool installed_since_gc = false;
+    return installed_since_gc;
+}
+
+/**
+ * Versioned artifact directory or builder plugin build that collect_garbage() may remove.
+ */
+struct gc_candidate_t {
+    m03gagbhsnusi43zogoacgj2ez_filesystem::path_t dir;
+    std::filesystem::file_time_type last_built;
+};
+
+/**
+ * Installing a phase creates its directory under the entry and rebuilding recreates install/, so the newest
+ * of the entry and its direct children tells when the entry was last built.
+ */
+static std::filesystem::file_time_type last_built(const m03gagbhsnusi43zogoacgj2ez_filesystem::path_t& dir) {
+    auto result = m03gagbhsnusi43zogoacgj2ez_filesystem::last_write_time(dir);
+    for (const auto& child : m03gagbhsnusi43zogoacgj2ez_filesystem::find(
+        dir,
+        m03gagbhsnusi43zogoacgj2ez_filesystem::find_include_predicate_t::is_dir,
+        m03gagbhsnusi43zogoacgj2ez_filesystem::find_descend_predicate_t::descend_none
+    )) {
+        result = std::max(result, m03gagbhsnusi43zogoacgj2ez_filesystem::last_write_time(child.path()));
+    }
+
+    return result;
+}
+
+static std::vector<gc_candidate_t> gc_candidates(const std::vector<m03gagbhsnusi43zogoacgj2ez_filesystem::rooted_path_t>& dirs) {
+    std::vector<gc_candidate_t> result;
+    for (const auto& dir : dirs) {
+        result.push_back(gc_candidate_t {
+            .dir = dir.path(),
+            .last_built = last_built(dir.path())
+        });
+    }
+
+    std::sort(result.begin(), result.end(), [](const gc_candidate_t& a, const gc_candidate_t& b) {
+        return b.last_built < a.last_built;
+    });
+
+    return result;
+}
+
+static gc_policy_t read_gc_policy(const m03gagbhsnusi43zogoacgj2ez_filesystem::path_t& policy_path) {
+    std::ifstream ifs(policy_path.string());
+    if (!ifs) {
+        throw std::runtime_error(std::format("m03gagbhsujjf63n0w3r2w4q6h_build_phases::read_gc_policy: failed to open '{}'", policy_path));
+    }
+
+    gc_policy_t policy;
+    std::string key;
+    std::uintmax_t value;
+    while (ifs >> key) {
+        if (!(ifs >> value)) {
+            throw std::runtime_error(std::format("m03gagbhsujjf63n0w3r2w4q6h_build_phases::read_gc_policy: missing value for '{}' in '{}'", key, policy_path));
+        }
+
+        if (key == "keep_versions") {
+            policy.keep_versions = static_cast<std::size_t>(value);
+        } else if (key == "max_bytes") {
+            policy.max_bytes = value;
+        } else {
+            throw std::runtime_error(std::format("m03gagbhsujjf63n0w3r2w4q6h_build_phases::read_gc_policy: unknown key '{}' in '{}', expected keep_versions or max_bytes", key, policy_path));
+        }
+    }
+
+    return policy;
+}
+
+/**
+ * Bytes that removing path frees at once: the files under it with no other hard link.
+ *
+ * Files that share a blob are counted when the blob store drops the blob.
+ */
+static std::uintmax_t unlinked_bytes(const m03gagbhsnusi43zogoacgj2ez_filesystem::path_t& path) {
+    m03gagbhsnusi43zogoacgj2ez_filesystem::disk_usage_t usage;
+    if (!m03gagbhsnusi43zogoacgj2ez_filesystem::is_directory(path)) {
+        return m03gagbhsnusi43zogoacgj2ez_filesystem::hard_link_count(path) == 1 ? usage.add(path) : 0;
+    }
+
+    for (const auto& file : m03gagbhsnusi43zogoacgj2ez_filesystem::find(
+        path,
+        !m03gagbhsnusi43zogoacgj2ez_filesystem::find_include_predicate_t::is_dir,
+        m03gagbhsnusi43zogoacgj2ez_filesystem::find_descend_predicate_t::descend_all
+    )) {
+        if (m03gagbhsnusi43zogoacgj2ez_filesystem::is_symlink(file.path()) || m03gagbhsnusi43zogoacgj2ez_filesystem::hard_link_count(file.path()) == 1) {
+            usage.add(file.path());
+        }
+    }
+
+    return usage.total();
+}
+
+/**
+ * Include trees under cache_dir built from an install that no longer has a manifest, or that have no inputs
+ * file because their build was interrupted.
+ */
+static std::vector<m03gagbhsnusi43zogoacgj2ez_filesystem::path_t> stale_include_trees(const m03gagbhsnusi43zogoacgj2ez_filesystem::path_t& cache_dir) {
+    std::vector<m03gagbhsnusi43zogoacgj2ez_filesystem::path_t> result;
+    if (!m03gagbhsnusi43zogoacgj2ez_filesystem::exists(cache_dir)) {
+        return result;
+    }
+
+    const auto entries = m03gagbhsnusi43zogoacgj2ez_filesystem::find(
+        cache_dir,
+        m03gagbhsnusi43zogoacgj2ez_filesystem::find_include_predicate_t::include_all,
+        m03gagbhsnusi43zogoacgj2ez_filesystem::find_descend_predicate_t::descend_none
+    );
+    std::unordered_set<std::string> names;
+    for (const auto& entry : entries) {
+        names.insert(entry.path().filename());
+    }
+
+    for (const auto& entry : entries) {
+        const auto name = entry.path().filename();
+        if (name.ends_with("_tmp")) {
+            result.push_back(entry.path());
+            continue ;
+        }
+
+        if (name.ends_with(".inputs")) {
+            // Inputs whose entry was never published.
+            const auto key = name.substr(0, name.size() - std::string_view(".inputs").size());
+            if (!names.contains(key)) {
+                result.push_back(entry.path());
+            }
+            continue ;
+        }
+
+        const auto inputs_path = include_tree_inputs_path(cache_dir, name);
+        bool stale = !m03gagbhsnusi43zogoacgj2ez_filesystem::exists(inputs_path);
+        if (!stale) {
+            std::ifstream ifs(inputs_path.string());
+            if (!ifs) {
+                throw std::runtime_error(std::format("m03gagbhsujjf63n0w3r2w4q6h_build_phases::stale_include_trees: failed to open file '{}'", inputs_path));
+            }
+
+            std::string install_dir;
+            while (!stale && std::getline(ifs, install_dir)) {
+                stale = !m03gagbhsnusi43zogoacgj2ez_filesystem::exists(manifest_path(m03gagbhsnusi43zogoacgj2ez_filesystem::path_t(install_dir)));
+            }
+        }
+
+        if (stale) {
+            result.push_back(entry.path());
+            if (m03gagbhsnusi43zogoacgj2ez_filesystem::exists(inputs_path)) {
+                result.push_back(inputs_path);
+            }
+        }
+    }
+
+    return result;
+}
+
+/**
+ * Build directories under <scratch_root>/<module> whose version or plugin no longer exists under the artifact root.
+ *
+ * Successful phases remove their build directories, so these are leftovers of failed or interrupted builds.
+ */
+static std::vector<m03gagbhsnusi43zogoacgj2ez_filesystem::path_t> stale_scratch_dirs(
+    const m03gagbhsnusi43zogoacgj2ez_filesystem::path_t& artifact_root,
+    const m03gagbhsnusi43zogoacgj2ez_filesystem::path_t& scratch_root
+) {
+    std::vector<m03gagbhsnusi43zogoacgj2ez_filesystem::path_t> result;
+    if (!m03gagbhsnusi43zogoacgj2ez_filesystem::exists(scratch_root)) {
+        return result;
+    }
+
+    // The same path under the artifact root as dir has under the scratch root.
+    const auto orphaned = [&](const m03gagbhsnusi43zogoacgj2ez_filesystem::path_t& dir) {
+        return !m03gagbhsnusi43zogoacgj2ez_filesystem::exists(artifact_root / scratch_root.relative(dir));
+    };
+
+    for (const auto& module_dir : m03gagbhsnusi43zogoacgj2ez_filesystem::find(
+        scratch_root,
+        m03gagbhsnusi43zogoacgj2ez_filesystem::find_include_predicate_t::is_dir,
+        m03gagbhsnusi43zogoacgj2ez_filesystem::find_descend_predicate_t::descend_none
+    )) {
+        // Only modules this artifact root knows about, in case the scratch root holds anything else.
+        if (orphaned(module_dir.path())) {
+            continue ;
+        }
+
+        for (const auto& dir : m03gagbhsnusi43zogoacgj2ez_filesystem::find(
+            module_dir.path(),
+            m03gagbhsnusi43zogoacgj2ez_filesystem::find_include_predicate_t::is_dir,
+            m03gagbhsnusi43zogoacgj2ez_filesystem::find_descend_predicate_t::descend_none
+        )) {
+            if (dir.path().filename() == "builder") {
+                for (const auto& plugin_dir : m03gagbhsnusi43zogoacgj2ez_filesystem::find(
+                    dir.path(),
+                    m03gagbhsnusi43zogoacgj2ez_filesystem::find_include_predicate_t::is_dir,
+                    m03gagbhsnusi43zogoacgj2ez_filesystem::find_descend_predicate_t::descend_none
+                )) {
+                    if (orphaned(plugin_dir.path())) {
+                        result.push_back(plugin_dir.path());
+                    }
+                }
+            } else if (
+                (module_dir.path().filename() == DEFAULT_CLI_DIR || dir.path().filename().starts_with(module_dir.path().filename() + "@")) &&
+                orphaned(dir.path())
+            ) {
+                result.push_back(dir.path());
+            }
+        }
+    }
+
+    return result;
+}
+
+std::optional<gc_result_t> collect_garbage(const m03gagbhsp2drqq3gkop8pzfrm_workspace_graph::invocation_context_t& invocation_context, const gc_policy_t& policy, bool wait) {
+    const auto& artifact_root = invocation_context.artifact_root;
+    if (install_locks()[artifact_root.string()].depth != 0) {
+        throw std::runtime_error(std::format("m03gagbhsujjf63n0w3r2w4q6h_build_phases::collect_garbage: '{}' is being installed into by this process", artifact_root));
+    }
+
+    const int lock_fd = lock_artifact_root(artifact_root, wait ? LOCK_EX : LOCK_EX | LOCK_NB);
+    if (lock_fd == -1) {
+        return std::nullopt;
+    }
+
+    gc_result_t result {
+        .removed_dirs = 0,
+        .removed_blobs = 0,
+        .removed_bytes = 0
+    };
+
+    try {
+        std::vector<m03gagbhsnusi43zogoacgj2ez_filesystem::path_t> stale;
+        std::vector<gc_candidate_t> kept;
+        std::vector<m03gagbhsnusi43zogoacgj2ez_filesystem::path_t> reachable_dirs;
+
+        // Without limits every unreachable entry is stale; max_bytes alone keeps the newest entries that fit.
+        const auto keep_count = [&](std::size_t count) {
+            return policy.keep_versions.value_or(policy.max_bytes ? count : 0);
+        };
+        const auto rank = [&](std::vector<gc_candidate_t> candidates) {
+            for (std::size_t i = 0; i < candidates.size(); ++i) {
+                if (i < keep_count(candidates.size())) {
+                    kept.push_back(std::move(candidates[i]));
+                } else {
+                    stale.push_back(std::move(candidates[i].dir));
+                }
+            }
+        };
+
+        for (const auto& module_dir : m03gagbhsnusi43zogoacgj2ez_filesystem::find(
+            artifact_root,
+            m03gagbhsnusi43zogoacgj2ez_filesystem::find_include_predicate_t::is_dir,
+            m03gagbhsnusi43zogoacgj2ez_filesystem::find_descend_predicate_t::descend_none
+        )) {
+            const auto module_name = module_dir.path().filename();
+
+            // Only the most recently built default CLI template matches the running builder and toolchain.
+            if (module_name == DEFAULT_CLI_DIR) {
+                auto templates = gc_candidates(m03gagbhsnusi43zogoacgj2ez_filesystem::find(
+                    module_dir.path(),
+                    m03gagbhsnusi43zogoacgj2ez_filesystem::find_include_predicate_t::is_dir,
+                    m03gagbhsnusi43zogoacgj2ez_filesystem::find_descend_predicate_t::descend_none
+                ));
+                for (std::size_t i = 1; i < templates.size(); ++i) {
+                    stale.push_back(std::move(templates[i].dir));
+                }
+                continue ;
+            }
+
+            const auto latest_dir = module_dir.path() / m03gagbhsnusi43zogoacgj2ez_filesystem::relative_path_t("latest");
+            const auto plugins_dir = module_dir.path() / m03gagbhsnusi43zogoacgj2ez_filesystem::relative_path_t("builder");
+
+            // latest/<phase> links point at <module>@<version>/<phase>; the bootstrap plugin link keeps <module>@0.
+            std::unordered_set<std::string> reachable;
+            if (m03gagbhsnusi43zogoacgj2ez_filesystem::exists(latest_dir)) {
+                for (const auto& link : m03gagbhsnusi43zogoacgj2ez_filesystem::find(
+                    latest_dir,
+                    m03gagbhsnusi43zogoacgj2ez_filesystem::find_include_predicate_t::include_all,
+                    m03gagbhsnusi43zogoacgj2ez_filesystem::find_descend_predicate_t::descend_none
+                )) {
+                    if (m03gagbhsnusi43zogoacgj2ez_filesystem::is_symlink(link.path())) {
+                        const auto reachable_dir = m03gagbhsnusi43zogoacgj2ez_filesystem::read_symlink(link.path()).parent();
+                        if (reachable.insert(reachable_dir.string()).second && m03gagbhsnusi43zogoacgj2ez_filesystem::exists(reachable_dir)) {
+                            reachable_dirs.push_back(reachable_dir);
+                        }
+                    }
+                }
+            }
+
+            std::vector<m03gagbhsnusi43zogoacgj2ez_filesystem::rooted_path_t> versions;
+            for (const auto& dir : m03gagbhsnusi43zogoacgj2ez_filesystem::find(
+                module_dir.path(),
+                m03gagbhsnusi43zogoacgj2ez_filesystem::find_include_predicate_t::is_dir,
+                m03gagbhsnusi43zogoacgj2ez_filesystem::find_descend_predicate_t::descend_none
+            )) {
+                const auto name = dir.path().filename();
+                if (name.ends_with(".gc")) {
+                    stale.push_back(dir.path());
+                } else if (name.starts_with(module_name + "@") && !reachable.contains(dir.path().string()) && !m03gagbhsnusi43zogoacgj2ez_filesystem::is_symlink(dir.path())) {
+                    versions.push_back(dir);
+                }
+            }
+
+            std::vector<m03gagbhsnusi43zogoacgj2ez_filesystem::rooted_path_t> plugin_dirs;
+            if (m03gagbhsnusi43zogoacgj2ez_filesystem::exists(plugins_dir)) {
+                for (const auto& dir : m03gagbhsnusi43zogoacgj2ez_filesystem::find(
+                    plugins_dir,
+                    m03gagbhsnusi43zogoacgj2ez_filesystem::find_include_predicate_t::is_dir,
+                    m03gagbhsnusi43zogoacgj2ez_filesystem::find_descend_predicate_t::descend_none
+                )) {
+                    if (dir.path().filename().ends_with(".gc")) {
+                        stale.push_back(dir.path());
+                    } else {
+                        plugin_dirs.push_back(dir);
+                    }
+                }
+            }
+
+            // The most recently built plugin is the one the current builder.cpp most likely hashes to.
+            auto plugins = gc_candidates(plugin_dirs);
+            if (!plugins.empty()) {
+                plugins.erase(plugins.begin());
+            }
+
+            rank(std::move(plugins));
+            rank(gc_candidates(versions));
+        }
+
+        if (policy.max_bytes) {
+            std::sort(kept.begin(), kept.end(), [](const gc_candidate_t& a, const gc_candidate_t& b) {
+                return b.last_built < a.last_built;
+            });
+
+            // Blobs are charged once, to the newest entry linking them, and not at all when a latest version links them too.
+            m03gagbhsnusi43zogoacgj2ez_filesystem::disk_usage_t usage;
+            for (const auto& reachable_dir : reachable_dirs) {
+                usage.add(reachable_dir);
+            }
+
+            std::uintmax_t kept_bytes = 0;
+            for (const auto& candidate : kept) {
+                kept_bytes += usage.add(candidate.dir);
+                if (*policy.max_bytes < kept_bytes) {
+                    stale.push_back(candidate.dir);
+                }
+            }
+        }
 
-static m03gagbhsmhr0naw0zpccv4gaq_cxx_toolchain::link_inputs_t binary_link_inputs(
-    const m03gagbhsp2drqq3gkop8pzfrm_workspace_graph::module_t& module,
-    build_config_t build_config
-) {
-    bool static_libraries = false;
-    switch (build_config.library_type) {
-        case m03gagbhsmhr0naw0zpccv4gaq_cxx_toolchain::library_type_t::STATIC: static_libraries = true; break ;
-        case m03gagbhsmhr0naw0zpccv4gaq_cxx_toolchain::library_type_t::SHARED: break ;
-        default: throw std::runtime_error(std::format("m03gagbhsujjf63n0w3r2w4q6h_build_phases::binary_link_inputs: unknown library_type {}", static_cast<std::underlying_type_t<m03gagbhsmhr0naw0zpccv4gaq_cxx_toolchain::library_type_t>>(build_config.library_type)));
-    }
+        for (const auto& dir : stale) {
+            std::cout << std::format("rm -rf {}", m03gagbhsnusi43zogoacgj2ez_filesystem::pretty_path_t(dir)) << std::endl;
 
-    const auto closure_groups = module.closure_groups();
+            // Renamed first so an interrupted removal never leaves a manifest next to a partial install.
+            auto removed_dir = dir;
+            if (!dir.filename().ends_with(".gc")) {
+                removed_dir = dir + ".gc";
+                if (m03gagbhsnusi43zogoacgj2ez_filesystem::exists(removed_dir)) {
+                    m03gagbhsnusi43zogoacgj2ez_filesystem::remove_all(removed_dir);
+                }
+                m03gagbhsnusi43zogoacgj2ez_filesystem::rename_strict(dir, removed_dir);
+            }
 
-    m03gagbhsmhr0naw0zpccv4gaq_cxx_toolchain::link_inputs_t result;
-    for (auto group_it = closure_groups.rbegin(); group_it != closure_groups.rend(); ++group_it) {
-        m03gagbhsmhr0naw0zpccv4gaq_cxx_toolchain::link_input_group_t group {
-            .libraries = {},
-            .static_library_group = false
-        };
+            result.removed_bytes += unlinked_bytes(removed_dir);
+            m03gagbhsnusi43zogoacgj2ez_filesystem::remove_all(removed_dir);
+            ++result.removed_dirs;
+        }
 
-        for (auto module_it = group_it->rbegin(); module_it != group_it->rend(); ++module_it) {
-            const auto phase = phase_base_t::make(**module_it, build_config);
-            const auto libraries = phase->install<library_phase_t>();
-            for (const auto& library : m03gagbhsnusi43zogoacgj2ez_filesystem::find(libraries.root(), !m03gagbhsnusi43zogoacgj2ez_filesystem::find_include_predicate_t::is_dir, m03gagbhsnusi43zogoacgj2ez_filesystem::find_descend_predicate_t::descend_all)) {
-                group.libraries.push_back(library.path());
+        // Include trees are rebuilt on demand, and their links to collected headers would keep blobs alive.
+        for (const auto& entry : stale_include_trees(invocation_context.scratch_root / m03gagbhsnusi43zogoacgj2ez_filesystem::relative_path_t(INCLUDE_TREE_DIR))) {
+            std::cout << std::format("rm -rf {}", m03gagbhsnusi43zogoacgj2ez_filesystem::pretty_path_t(entry)) << std::endl;
+            result.removed_bytes += unlinked_bytes(entry);
+            m03gagbhsnusi43zogoacgj2ez_filesystem::remove_all(entry);
+            if (!entry.filename().ends_with(".inputs")) {
+                ++result.removed_dirs;
             }
         }
 
-        if (!group.libraries.empty()) {
-            group.static_library_group = static_libraries && 1 < group.libraries.size();
-            result.groups.push_back(group);
+        // No build holds the lock, so nothing is compiling into the scratch root of this artifact root.
+        if (invocation_context.scratch_root != artifact_root) {
+            for (const auto& dir : stale_scratch_dirs(artifact_root, invocation_context.scratch_root)) {
+                std::cout << std::format("rm -rf {}", m03gagbhsnusi43zogoacgj2ez_filesystem::pretty_path_t(dir)) << std::endl;
+                result.removed_bytes += unlinked_bytes(dir);
+                m03gagbhsnusi43zogoacgj2ez_filesystem::remove_all(dir);
+                ++result.removed_dirs;
+            }
+        }
+
+        // Blobs no install links to any more, and leftovers of interrupted blob writes.
+        const auto blob_store = artifact_root / m03gagbhsnusi43zogoacgj2ez_filesystem::relative_path_t(BLOB_STORE_DIR);
+        if (m03gagbhsnusi43zogoacgj2ez_filesystem::exists(blob_store)) {
+            for (const auto& blob : m03gagbhsnusi43zogoacgj2ez_filesystem::find(
+                blob_store,
+                !m03gagbhsnusi43zogoacgj2ez_filesystem::find_include_predicate_t::is_dir,
+                m03gagbhsnusi43zogoacgj2ez_filesystem::find_descend_predicate_t::descend_all
+            )) {
+                if (blob.path().filename().ends_with("_tmp") || m03gagbhsnusi43zogoacgj2ez_filesystem::hard_link_count(blob.path()) == 1) {
+                    result.removed_bytes += unlinked_bytes(blob.path());
+                    m03gagbhsnusi43zogoacgj2ez_filesystem::remove(blob.path());
+                    ++result.removed_blobs;
+                }
+            }
         }
+    } catch (...) {
+        ::close(lock_fd);
+        throw ;
     }
 
-    return result;
-}
+    ::close(lock_fd);
+    forget_missing_installs();
 
-static m03gagbhsnusi43zogoacgj2ez_filesystem::path_t builder_dir(const m03gagbhsp2drqq3gkop8pzfrm_workspace_graph::module_t& module) {
-    return module.artifact_dir() / m03gagbhsnusi43zogoacgj2ez_filesystem::relative_path_t("builder");
+    return result;
 }
 
-static m03gagbhsnusi43zogoacgj2ez_filesystem::path_t builder_build_dir(const m03gagbhsp2drqq3gkop8pzfrm_workspace_graph::module_t& module) {
-    return builder_dir(module) / m03gagbhsnusi43zogoacgj2ez_filesystem::relative_path_t("build");
-}
+void collect_garbage_after_build(const m03gagbhsp2drqq3gkop8pzfrm_workspace_graph::invocation_context_t& invocation_context) {
+    if (!std::exchange(installed_since_gc(), false)) {
+        return ;
+    }
 
-static m03gagbhsnusi43zogoacgj2ez_filesystem::path_t builder_install_dir(const m03gagbhsp2drqq3gkop8pzfrm_workspace_graph::module_t& module) {
-    return builder_dir(module) / m03gagbhsnusi43zogoacgj2ez_filesystem::relative_path_t("install");
-}
+    const auto& artifact_root = invocation_context.artifact_root;
+    const auto policy_path = artifact_root / m03gagbhsnusi43zogoacgj2ez_filesystem::relative_path_t(GC_POLICY_FILE);
+    if (!m03gagbhsnusi43zogoacgj2ez_filesystem::exists(policy_path)) {
+        return ;
+    }
 
-static m03gagbhsnusi43zogoacgj2ez_filesystem::path_t builder_install_path(const m03gagbhsp2drqq3gkop8pzfrm_workspace_graph::module_t& module) {
-    return builder_install_dir(module) / m03gagbhsnusi43zogoacgj2ez_filesystem::relative_path_t("builder.so");
+    collect_garbage(invocation_context, read_gc_policy(policy_path), false);
 }
 
 static m03gagbhsnusi43zogoacgj2ez_filesystem::path_t bootstrap_builder_plugin_path() {
@@ -156,11 +1416,13 @@ const m03gagbhsnusi43zogoacgj2ez_filesystem::rooted_path_t& phase_base_t::built_
 
 phase_base_t::phase_base_t(
     std::string_view name,
+    config_dependencies_t config_dependencies,
     m03gagbhsp2drqq3gkop8pzfrm_workspace_graph::module_t& module,
     build_config_t build_config,
     std::unique_ptr<phase_base_t> previous_phase
 ):
     m_name(name),
+    m_config_dependencies(config_dependencies),
     m_module(module),
     m_build_config(build_config),
     m_previous_phase(std::move(previous_phase))
@@ -223,8 +1485,121 @@ m03gagbhsnusi43zogoacgj2ez_filesystem::path_t phase_base_t::artifact_dir() const
     return m_module.artifact_dir() / m03gagbhsnusi43zogoacgj2ez_filesystem::relative_path_t(std::string(m_name));
 }
 
+m03gagbhsnusi43zogoacgj2ez_filesystem::path_t phase_base_t::config_dir(const m03gagbhsnusi43zogoacgj2ez_filesystem::path_t& dir) const {
+    if (!m_config_dependencies.library_type) {
+        return dir;
+    }
+
+    return dir / library_type_relative_dir(build_config().library_type);
+}
+
+std::optional<m03gagbhsmhr0naw0zpccv4gaq_cxx_toolchain::library_type_t> phase_base_t::keyed_library_type() const {
+    if (!m_config_dependencies.library_type) {
+        return std::nullopt;
+    }
+
+    return build_config().library_type;
+}
+
+/**
+ * Hash of every file under module.source_dir(), including builder.cpp and the defines it passes.
+ *
+ * Hashed once per process for each source version.
+ */
+static uint64_t source_fingerprint(const m03gagbhsp2drqq3gkop8pzfrm_workspace_graph::module_t& module) {
+    static std::unordered_map<std::string, uint64_t> source_fingerprints;
+
+    const auto source_dir = module.source_dir();
+    const auto key = std::format("{}@{}", source_dir, module.source_version().value);
+    if (const auto it = source_fingerprints.find(key); it != source_fingerprints.end()) {
+        return it->second;
+    }
+
+    auto source_files = m03gagbhsnusi43zogoacgj2ez_filesystem::find(
+        source_dir,
+        !m03gagbhsnusi43zogoacgj2ez_filesystem::find_include_predicate_t::is_dir,
+        m03gagbhsnusi43zogoacgj2ez_filesystem::find_descend_predicate_t::descend_all
+    );
+    std::sort(source_files.begin(), source_files.end(), [](const m03gagbhsnusi43zogoacgj2ez_filesystem::rooted_path_t& a, const m03gagbhsnusi43zogoacgj2ez_filesystem::rooted_path_t& b) {
+        return a.relative_path().string() < b.relative_path().string();
+    });
+
+    fingerprint_t fingerprint;
+    for (const auto& source_file : source_files) {
+        fingerprint.mix(source_file.relative_path().string());
+        fingerprint.mix(m03gagbhsnusi43zogoacgj2ez_filesystem::content_hash(source_file.path()));
+    }
+
+    return source_fingerprints.emplace(key, fingerprint.value()).first->second;
+}
+
+/**
+ * Hashes what this phase's outputs are built from beyond the module version that names install_dir(): the
+ * module's source contents, the build configuration fields the phase is keyed by, and the manifests of every
+ * earlier phase of each module in the dependency closure.
+ *
+ * An earlier install without a manifest is hashed as missing, so it is rehashed once the phase has run.
+ */
+uint64_t phase_base_t::input_fingerprint() const {
+    fingerprint_t fingerprint;
+    fingerprint.mix(m_name);
+    fingerprint.mix(source_fingerprint(m_module));
+    if (const auto library_type = keyed_library_type()) {
+        fingerprint.mix(static_cast<uint64_t>(*library_type));
+        fingerprint.mix(static_cast<uint64_t>(build_config().share_pic_objects));
+    }
+
+    const auto mix_earlier_phases = [&](const phase_base_t& phase) {
+        for (const auto* earlier_phase = phase.previous_phase(); earlier_phase != nullptr; earlier_phase = earlier_phase->previous_phase()) {
+            const auto earlier_install_dir = earlier_phase->install_dir();
+            fingerprint.mix(earlier_install_dir.string());
+
+            const manifest_t* manifest = nullptr;
+            if (m03gagbhsnusi43zogoacgj2ez_filesystem::exists(manifest_path(earlier_install_dir))) {
+                try {
+                    manifest = &read_manifest(earlier_install_dir);
+                } catch (const std::runtime_error&) {
+                    // Rebuilt by its own install, which then changes this fingerprint.
+                }
+            }
+            if (!manifest) {
+                fingerprint.mix("missing");
+                continue ;
+            }
+
+            for (const auto& entry : manifest->entries) {
+                fingerprint.mix(entry.relative_path.string());
+                fingerprint.mix(entry.content_hash);
+            }
+        }
+    };
+
+    for (const auto& module_group : m_module.closure_groups()) {
+        for (auto* module : module_group) {
+            if (module == &m_module) {
+                mix_earlier_phases(*this);
+                continue ;
+            }
+
+            const auto dependency_chain = phase_base_t::make(*module, m_build_config);
+            for (const auto* phase = dependency_chain.get(); phase != nullptr; phase = phase->previous_phase()) {
+                if (phase->name() == m_name) {
+                    mix_earlier_phases(*phase);
+                    break ;
+                }
+            }
+        }
+    }
+
+    return fingerprint.value();
+}
+
 m03gagbhsnusi43zogoacgj2ez_filesystem::path_t phase_base_t::build_dir() const {
-    return artifact_dir() / m03gagbhsnusi43zogoacgj2ez_filesystem::relative_path_t("build") / library_type_relative_dir(build_config().library_type);
+    return config_dir(
+        m_module.artifact_scratch_dir()
+            / m03gagbhsnusi43zogoacgj2ez_filesystem::relative_path_t(std::string(m_name))
+            / m03gagbhsnusi43zogoacgj2ez_filesystem::relative_path_t("build")
+    );
 }
 
 phase_base_t::built_t phase_base_t::build(const m03gagbhsnusi43zogoacgj2ez_filesystem::path_t& path) const {
@@ -272,7 +1647,7 @@ phase_base_t::built_t phase_base_t::build(const m03gagbhsnusi43zogoacgj2ez_files
 }
 
 m03gagbhsnusi43zogoacgj2ez_filesystem::path_t phase_base_t::install_dir() const {
-    return artifact_dir() / m03gagbhsnusi43zogoacgj2ez_filesystem::relative_path_t("install") / library_type_relative_dir(build_config().library_type);
+    return config_dir(artifact_dir() / m03gagbhsnusi43zogoacgj2ez_filesystem::relative_path_t("install"));
 }
 
 void phase_base_t::install_as(
@@ -285,7 +1660,20 @@ void phase_base_t::install_as(
         throw std::runtime_error(std::format("m03gagbhsujjf63n0w3r2w4q6h_build_phases::phase_base_t::install_as: phase '{}' already has an artifact at relative path '{}'", name(), install_dir().relative(installed_artifact)));
     }
 
-    m03gagbhsnusi43zogoacgj2ez_filesystem::copy(path, installed_artifact);
+    install_file(path, installed_artifact, m_module.workspace().graph(), false);
+}
+
+void phase_base_t::install_snapshot_as(
+    const m03gagbhsnusi43zogoacgj2ez_filesystem::path_t& path,
+    const m03gagbhsnusi43zogoacgj2ez_filesystem::relative_path_t& relative_path
+) const {
+    const auto installed_artifact = install_dir() / relative_path;
+
+    if (m03gagbhsnusi43zogoacgj2ez_filesystem::exists(installed_artifact)) {
+        throw std::runtime_error(std::format("m03gagbhsujjf63n0w3r2w4q6h_build_phases::phase_base_t::install_snapshot_as: phase '{}' already has an artifact at relative path '{}'", name(), relative_path));
+    }
+
+    install_file(path, installed_artifact, m_module.workspace().graph(), true);
 }
 
 const phase_base_t* phase_base_t::previous_phase() const {
@@ -344,100 +1732,117 @@ void phase_base_t::install(const built_t& built) const {
 }
 
 m03gagbhsnusi43zogoacgj2ez_filesystem::path_t phase_base_t::builder_plugin() const {
-    const auto plugin_path = builder_install_path(m_module);
-    const auto build_dir = builder_build_dir(m_module);
-    const auto install_dir = builder_install_dir(m_module);
-    const auto marker_path = [&](std::string_view state) {
-        return build_dir / m03gagbhsnusi43zogoacgj2ez_filesystem::relative_path_t(std::format("builder.{}", state));
-    };
-    const auto started_marker = marker_path("started");
-    const auto complete_marker = marker_path("complete");
-
     if (m_module.workspace().graph().is_active_builder_bootstrap_module(m_module)) {
         return bootstrap_builder_plugin_path();
     }
 
-    if (m03gagbhsnusi43zogoacgj2ez_filesystem::exists(complete_marker)) {
-        if (!m03gagbhsnusi43zogoacgj2ez_filesystem::exists(plugin_path)) {
-            throw std::runtime_error(std::format("m03gagbhsujjf63n0w3r2w4q6h_build_phases::phase_base_t::builder_plugin: completed builder plugin '{}' does not exist", plugin_path));
-        }
-
-        return plugin_path;
+    auto key = phase_key(m_module, "builder", m03gagbhsmhr0naw0zpccv4gaq_cxx_toolchain::library_type_t::SHARED);
+    if (const auto it = completed_phases().find(key); it != completed_phases().end()) {
+        return it->second;
     }
 
-    if (m03gagbhsnusi43zogoacgj2ez_filesystem::exists(started_marker)) {
-        throw std::runtime_error(std::format("m03gagbhsujjf63n0w3r2w4q6h_build_phases::phase_base_t::builder_plugin: re-entry detected for builder plugin '{}'", plugin_path));
-    }
-
-    if (m03gagbhsnusi43zogoacgj2ez_filesystem::exists(build_dir)) {
-        m03gagbhsnusi43zogoacgj2ez_filesystem::remove_all(build_dir);
-    }
-    if (m03gagbhsnusi43zogoacgj2ez_filesystem::exists(install_dir)) {
-        m03gagbhsnusi43zogoacgj2ez_filesystem::remove_all(install_dir);
+    if (!started_phases().insert(key).second) {
+        throw std::runtime_error(std::format("m03gagbhsujjf63n0w3r2w4q6h_build_phases::phase_base_t::builder_plugin: re-entry detected for builder plugin of module '{}'", m_module.name()));
     }
 
     try {
-        {
-            m03gagbhsyhlx2pk5sdabbr1sx_signal_handler::scoped_termination_guard_t termination_guard;
+        std::vector<m03gagbhsnusi43zogoacgj2ez_filesystem::path_t> include_dirs;
+        std::vector<m03gagbhsnusi43zogoacgj2ez_filesystem::path_t> library_dirs;
+        for (auto* dependency : m_module.builder_dependencies()) {
+            const auto dependency_phase = phase_base_t::make(
+                *dependency,
+                build_config_t { .library_type = m03gagbhsmhr0naw0zpccv4gaq_cxx_toolchain::library_type_t::SHARED }
+            );
+
+            for (const auto& dependency_include_dirs : dependency_phase->install_closure<interface_phase_t>()) {
+                include_dirs.push_back(dependency_include_dirs.root());
+            }
 
-            m03gagbhsnusi43zogoacgj2ez_filesystem::create_directories(build_dir);
-            m03gagbhsnusi43zogoacgj2ez_filesystem::touch(started_marker);
+            for (const auto& dependency_libraries : dependency_phase->install_closure<library_phase_t>()) {
+                library_dirs.push_back(dependency_libraries.root());
+            }
+        }
 
-            std::vector<m03gagbhsnusi43zogoacgj2ez_filesystem::path_t> include_dirs;
-            std::vector<m03gagbhsnusi43zogoacgj2ez_filesystem::path_t> libraries;
+        const auto plugin_key = builder_plugin_key(m_module, include_dirs, library_dirs);
+        const auto build_dir = builder_build_dir(m_module, plugin_key);
+        const auto install_dir = builder_dir(m_module, plugin_key) / m03gagbhsnusi43zogoacgj2ez_filesystem::relative_path_t("install");
+        const auto plugin_path = install_dir / m03gagbhsnusi43zogoacgj2ez_filesystem::relative_path_t("builder.so");
 
-            for (auto* dependency : m_module.builder_dependencies()) {
-                const auto dependency_phase = phase_base_t::make(
-                    *dependency,
-                    build_config_t { .library_type = m03gagbhsmhr0naw0zpccv4gaq_cxx_toolchain::library_type_t::SHARED }
-                );
+        if (!has_manifest(install_dir, plugin_key, false)) {
+            scoped_install_lock_t install_lock(m_module.workspace().graph().artifact_root());
+            scoped_phase_lock_t phase_lock(install_dir);
 
-                for (const auto& dependency_include_dirs : dependency_phase->install_closure<interface_phase_t>()) {
-                    include_dirs.push_back(dependency_include_dirs.root());
+            // Another process may have built the plugin while this one waited for the lock.
+            if (!has_manifest(install_dir, plugin_key, false)) {
+                if (m03gagbhsnusi43zogoacgj2ez_filesystem::exists(build_dir)) {
+                    m03gagbhsnusi43zogoacgj2ez_filesystem::remove_all(build_dir);
+                }
+                if (m03gagbhsnusi43zogoacgj2ez_filesystem::exists(install_dir)) {
+                    m03gagbhsnusi43zogoacgj2ez_filesystem::remove_all(install_dir);
                 }
 
-                for (const auto& dependency_libraries : dependency_phase->install_closure<library_phase_t>()) {
-                    for (const auto& library : m03gagbhsnusi43zogoacgj2ez_filesystem::find(dependency_libraries.root(), !m03gagbhsnusi43zogoacgj2ez_filesystem::find_include_predicate_t::is_dir, m03gagbhsnusi43zogoacgj2ez_filesystem::find_descend_predicate_t::descend_all)) {
-                        libraries.push_back(library.path());
+                try {
+                    {
+                        m03gagbhsyhlx2pk5sdabbr1sx_signal_handler::scoped_termination_guard_t termination_guard;
+
+                        m03gagbhsnusi43zogoacgj2ez_filesystem::create_directories(build_dir);
+
+                        std::vector<m03gagbhsnusi43zogoacgj2ez_filesystem::path_t> libraries;
+                        for (const auto& library_dir : library_dirs) {
+                            for (const auto& library : installed_files(library_dir)) {
+                                libraries.push_back(library);
+                            }
+                        }
+
+                        m03gagbhsmhr0naw0zpccv4gaq_cxx_toolchain::link_inputs_t link_inputs;
+                        if (!libraries.empty()) {
+                            link_inputs.groups.push_back(m03gagbhsmhr0naw0zpccv4gaq_cxx_toolchain::link_input_group_t {
+                                .libraries = libraries,
+                                .static_library_group = false
+                            });
+                        }
+
+                        m03gagbhsmhr0naw0zpccv4gaq_cxx_toolchain::build_library(
+                            build_dir,
+                            include_dirs,
+                            {
+                                m03gagbhsnusi43zogoacgj2ez_filesystem::rooted_path_t(
+                                    m_module.source_dir(),
+                                    m03gagbhsnusi43zogoacgj2ez_filesystem::relative_path_t(m03gagbhsp2drqq3gkop8pzfrm_workspace_graph::BUILDER_CPP)
+                                )
+                            },
+                            {},
+                            m03gagbhsmhr0naw0zpccv4gaq_cxx_toolchain::library_type_t::SHARED,
+                            link_inputs,
+                            plugin_path
+                        );
                     }
-                }
-            }
 
-            m03gagbhsmhr0naw0zpccv4gaq_cxx_toolchain::link_inputs_t link_inputs;
-            if (!libraries.empty()) {
-                link_inputs.groups.push_back(m03gagbhsmhr0naw0zpccv4gaq_cxx_toolchain::link_input_group_t {
-                    .libraries = libraries,
-                    .static_library_group = false
-                });
-            }
-
-            m03gagbhsmhr0naw0zpccv4gaq_cxx_toolchain::build_library(
-                build_dir,
-                include_dirs,
-                {
-                    m03gagbhsnusi43zogoacgj2ez_filesystem::rooted_path_t(
-                        m_module.source_dir(),
-                        m03gagbhsnusi43zogoacgj2ez_filesystem::relative_path_t(m03gagbhsp2drqq3gkop8pzfrm_workspace_graph::BUILDER_CPP)
-                    )
-                },
-                {},
-                m03gagbhsmhr0naw0zpccv4gaq_cxx_toolchain::library_type_t::SHARED,
-                link_inputs,
-                plugin_path
-            );
-        }
+                    if (!m03gagbhsnusi43zogoacgj2ez_filesystem::exists(plugin_path)) {
+                        throw std::runtime_error(std::format("m03gagbhsujjf63n0w3r2w4q6h_build_phases::phase_base_t::builder_plugin: expected builder plugin '{}' to exist", plugin_path));
+                    }
 
-        if (!m03gagbhsnusi43zogoacgj2ez_filesystem::exists(plugin_path)) {
-            throw std::runtime_error(std::format("m03gagbhsujjf63n0w3r2w4q6h_build_phases::phase_base_t::builder_plugin: expected builder plugin '{}' to exist", plugin_path));
+                    write_manifest(install_dir, plugin_key);
+                    installed_since_gc() = true;
+                    if (has_separate_scratch_root(m_module.workspace().graph())) {
+                        m03gagbhsnusi43zogoacgj2ez_filesystem::remove_all(build_dir);
+                    }
+                } catch (...) {
+                    m03gagbhsnusi43zogoacgj2ez_filesystem::remove_all(build_dir);
+                    m03gagbhsnusi43zogoacgj2ez_filesystem::remove_all(install_dir);
+                    throw ;
+                }
+            }
+        } else if (!m03gagbhsnusi43zogoacgj2ez_filesystem::exists(plugin_path)) {
+            throw std::runtime_error(std::format("m03gagbhsujjf63n0w3r2w4q6h_build_phases::phase_base_t::builder_plugin: completed builder plugin '{}' does not exist", plugin_path));
         }
 
-        m03gagbhsnusi43zogoacgj2ez_filesystem::touch(complete_marker);
-        m03gagbhsnusi43zogoacgj2ez_filesystem::remove(started_marker);
+        started_phases().erase(key);
+        completed_phases().emplace(std::move(key), plugin_path);
 
         return plugin_path;
     } catch (...) {
-        m03gagbhsnusi43zogoacgj2ez_filesystem::remove_all(build_dir);
-        m03gagbhsnusi43zogoacgj2ez_filesystem::remove_all(install_dir);
+        started_phases().erase(key);
         throw ;
     }
 }
@@ -447,7 +1852,7 @@ source_phase_t::source_phase_t(
     build_config_t build_config,
     std::unique_ptr<phase_base_t> previous_phase
 ):
-    phase_base_t("source", module, build_config, std::move(previous_phase))
+    phase_base_t("source", config_dependencies, module, build_config, std::move(previous_phase))
 {
 }
 
@@ -468,7 +1873,7 @@ void source_phase_t::install_source_tree() const {
     const auto source_root = source_dir();
 
     for (const auto& source : m03gagbhsnusi43zogoacgj2ez_filesystem::find(source_root, !m03gagbhsnusi43zogoacgj2ez_filesystem::find_include_predicate_t::is_dir, m03gagbhsnusi43zogoacgj2ez_filesystem::find_descend_predicate_t::descend_all)) {
-        install_as(source.path(), source.relative_path());
+        install_snapshot_as(source.path(), source.relative_path());
     }
 }
 
@@ -481,7 +1886,7 @@ interface_phase_t::interface_phase_t(
     build_config_t build_config,
     std::unique_ptr<phase_base_t> previous_phase
 ):
-    phase_base_t("interface", module, build_config, std::move(previous_phase))
+    phase_base_t("interface", config_dependencies, module, build_config, std::move(previous_phase))
 {
 }
 
@@ -541,7 +1946,7 @@ library_phase_t::library_phase_t(
     build_config_t build_config,
     std::unique_ptr<phase_base_t> previous_phase
 ):
-    phase_base_t("library", module, build_config, std::move(previous_phase))
+    phase_base_t("library", config_dependencies, module, build_config, std::move(previous_phase))
 {
 }
 
@@ -565,9 +1970,20 @@ m03gagbhsnusi43zogoacgj2ez_filesystem::path_t library_phase_t::build_library(
     const auto interfaces = install_closure<interface_phase_t>();
     const auto relative_output_path = module_library_relative_output_path(module().name(), library_type());
 
+    if (build_config().share_pic_objects) {
+        const auto include_dirs = include_dirs_from_outputs(interfaces);
+        const auto compiler_sources = compiler_source_files(source_files);
+        return m03gagbhsmhr0naw0zpccv4gaq_cxx_toolchain::link_library(
+            build_shared_objects(module(), name(), include_dirs, compiler_sources, defines, object_key(include_dirs, compiler_sources, defines)),
+            library_type(),
+            m03gagbhsmhr0naw0zpccv4gaq_cxx_toolchain::link_inputs_t {},
+            build_dir() / relative_output_path
+        );
+    }
+
     return m03gagbhsmhr0naw0zpccv4gaq_cxx_toolchain::build_library(
         build_dir(),
-        include_dirs_from_outputs(interfaces),
+        include_tree(module().workspace().graph(), include_dirs_from_outputs(interfaces)),
         compiler_source_files(source_files),
         defines,
         library_type(),
@@ -584,12 +2000,38 @@ void library_phase_t::install_library(const phase_base_t::built_t& library) cons
     install(library);
 }
 
+void library_phase_t::finalize_install() const {
+    if (library_type() != m03gagbhsmhr0naw0zpccv4gaq_cxx_toolchain::library_type_t::SHARED) {
+        return ;
+    }
+
+    const auto path = abi_stub_path(install_dir());
+    std::ofstream ofs(path.string(), std::ios::trunc);
+    if (!ofs) {
+        throw std::runtime_error(std::format("m03gagbhsujjf63n0w3r2w4q6h_build_phases::library_phase_t::finalize_install: failed to open file '{}'", path));
+    }
+
+    for (const auto& installed : m03gagbhsnusi43zogoacgj2ez_filesystem::find(
+        install_dir(),
+        !m03gagbhsnusi43zogoacgj2ez_filesystem::find_include_predicate_t::is_dir,
+        m03gagbhsnusi43zogoacgj2ez_filesystem::find_descend_predicate_t::descend_all
+    )) {
+        if (installed.path().extension() == ".so") {
+            ofs << std::format("{} {}\n", m03h2qrcln2fdgjro7rajbqejh_elf::abi_hash(installed.path()), installed.relative_path().string());
+        }
+    }
+
+    if (!ofs) {
+        throw std::runtime_error(std::format("m03gagbhsujjf63n0w3r2w4q6h_build_phases::library_phase_t::finalize_install: failed to write file '{}'", path));
+    }
+}
+
 binary_phase_t::binary_phase_t(
     m03gagbhsp2drqq3gkop8pzfrm_workspace_graph::module_t& module,
     build_config_t build_config,
     std::unique_ptr<phase_base_t> previous_phase
 ):
-    phase_base_t("binary", module, build_config, std::move(previous_phase))
+    phase_base_t("binary", config_dependencies, module, build_config, std::move(previous_phase))
 {
 }
 
@@ -610,6 +2052,140 @@ const m03gagbhsnusi43zogoacgj2ez_filesystem::path_t& binary_phase_t::installed_t
     return m_cli;
 }
 
+/**
+ * ABI hash of each shared library in install_dir, keyed by path, from its interface stub; empty without one.
+ */
+static std::unordered_map<std::string, uint64_t> read_abi_stub(const m03gagbhsnusi43zogoacgj2ez_filesystem::path_t& install_dir) {
+    std::unordered_map<std::string, uint64_t> result;
+
+    const auto path = abi_stub_path(install_dir);
+    if (!m03gagbhsnusi43zogoacgj2ez_filesystem::exists(path)) {
+        return result;
+    }
+
+    std::ifstream ifs(path.string());
+    if (!ifs) {
+        throw std::runtime_error(std::format("m03gagbhsujjf63n0w3r2w4q6h_build_phases::read_abi_stub: failed to open file '{}'", path));
+    }
+
+    std::string line;
+    while (std::getline(ifs, line)) {
+        const auto separator = line.find(' ');
+        if (separator == std::string::npos) {
+            throw std::runtime_error(std::format("m03gagbhsujjf63n0w3r2w4q6h_build_phases::read_abi_stub: malformed line '{}' in '{}'", line, path));
+        }
+
+        const auto library = install_dir / m03gagbhsnusi43zogoacgj2ez_filesystem::relative_path_t(line.substr(separator + 1));
+        result.emplace(library.string(), std::stoull(line.substr(0, separator)));
+    }
+
+    return result;
+}
+
+static std::optional<uint64_t> read_link_key(const m03gagbhsnusi43zogoacgj2ez_filesystem::path_t& install_dir) {
+    std::ifstream ifs(link_key_path(install_dir).string());
+    uint64_t result;
+    if (!(ifs >> result)) {
+        return std::nullopt;
+    }
+
+    return result;
+}
+
+/**
+ * Hashes what linking against shared libraries depends on: the objects, the toolchain, and the file name and
+ * interface stub of each library in link order. A library installed without a stub is keyed by its contents.
+ */
+static uint64_t link_key(
+    const m03gagbhsp2drqq3gkop8pzfrm_workspace_graph::workspace_graph_t& workspace_graph,
+    uint64_t objects_key,
+    const m03gagbhsmhr0naw0zpccv4gaq_cxx_toolchain::link_inputs_t& link_inputs,
+    const std::vector<library_phase_t::installed_t>& libraries
+) {
+    std::unordered_map<std::string, uint64_t> abi_hashes;
+    for (const auto& installed : libraries) {
+        abi_hashes.merge(read_abi_stub(installed.root()));
+    }
+
+    fingerprint_t fingerprint;
+    fingerprint.mix(objects_key);
+    fingerprint.mix(workspace_graph.bootstrap_seed_module().version().value);
+    for (const auto& group : link_inputs.groups) {
+        fingerprint.mix(static_cast<uint64_t>(group.static_library_group));
+        for (const auto& library : group.libraries) {
+            fingerprint.mix(library.filename());
+            const auto it = abi_hashes.find(library.string());
+            fingerprint.mix(it != abi_hashes.end() ? it->second : m03gagbhsnusi43zogoacgj2ez_filesystem::content_hash(library));
+        }
+    }
+
+    return fingerprint.value();
+}
+
+m03gagbhsnusi43zogoacgj2ez_filesystem::path_t binary_phase_t::link_cli_against_stubs(
+    const std::vector<m03gagbhsnusi43zogoacgj2ez_filesystem::path_t>& object_files,
+    uint64_t objects_key,
+    const m03gagbhsmhr0naw0zpccv4gaq_cxx_toolchain::link_inputs_t& link_inputs
+) const {
+    const auto cli = build_dir() / m03gagbhsnusi43zogoacgj2ez_filesystem::relative_path_t("cli");
+
+    std::vector<std::string> library_dirs;
+    for (const auto& group : link_inputs.groups) {
+        for (const auto& library : group.libraries) {
+            const auto library_dir = library.parent().string();
+            if (std::find(library_dirs.begin(), library_dirs.end(), library_dir) == library_dirs.end()) {
+                library_dirs.push_back(library_dir);
+            }
+        }
+    }
+
+    if (library_dirs.empty()) {
+        return m03gagbhsmhr0naw0zpccv4gaq_cxx_toolchain::link_binary(object_files, link_inputs, cli);
+    }
+
+    std::string runpath;
+    for (const auto& library_dir : library_dirs) {
+        if (!runpath.empty()) {
+            runpath.push_back(':');
+        }
+        runpath += library_dir;
+    }
+
+    const auto key = link_key(module().workspace().graph(), objects_key, link_inputs, install_closure<library_phase_t>());
+
+    // latest/ still points at the previous build of this phase until this one completes.
+    const auto previous_install_dir = module().artifact_latest_dir() / module().artifact_dir().relative(install_dir());
+    const auto previous_cli = previous_install_dir / m03gagbhsnusi43zogoacgj2ez_filesystem::relative_path_t("cli");
+    if (
+        m03gagbhsnusi43zogoacgj2ez_filesystem::exists(manifest_path(previous_install_dir)) &&
+        read_link_key(previous_install_dir) == key &&
+        m03gagbhsnusi43zogoacgj2ez_filesystem::exists(previous_cli)
+    ) {
+        // The installed CLI may be a read-only blob.
+        m03gagbhsnusi43zogoacgj2ez_filesystem::copy(previous_cli, cli);
+        m03gagbhsnusi43zogoacgj2ez_filesystem::permissions(cli, m03gagbhsnusi43zogoacgj2ez_filesystem::permissions(cli) | std::filesystem::perms::owner_write);
+    } else {
+        // Library directories of later builds differ only in their versions, which have at most 20 digits.
+        m03gagbhsmhr0naw0zpccv4gaq_cxx_toolchain::link_binary_with_runpath_placeholder(
+            object_files,
+            link_inputs,
+            runpath.size() + 20 * library_dirs.size(),
+            cli
+        );
+    }
+
+    m03h2qrcln2fdgjro7rajbqejh_elf::patch_runpath(cli, runpath);
+
+    const auto path = link_key_path(install_dir());
+    std::ofstream ofs(path.string(), std::ios::trunc);
+    ofs << key << "\n";
+    if (!ofs) {
+        throw std::runtime_error(std::format("m03gagbhsujjf63n0w3r2w4q6h_build_phases::binary_phase_t::link_cli_against_stubs: failed to write file '{}'", path));
+    }
+
+    return cli;
+}
+
 m03gagbhsnusi43zogoacgj2ez_filesystem::path_t binary_phase_t::build_cli(
     const std::vector<phase_base_t::built_t>& source_files,
     const std::vector<m03gagbhsmhr0naw0zpccv4gaq_cxx_toolchain::define_t>& defines
@@ -620,9 +2196,26 @@ m03gagbhsnusi43zogoacgj2ez_filesystem::path_t binary_phase_t::build_cli(
         build_config()
     );
 
+    if (build_config().share_pic_objects) {
+        const auto include_dirs = include_dirs_from_outputs(interfaces);
+        const auto compiler_sources = compiler_source_files(source_files);
+        const auto objects_key = object_key(include_dirs, compiler_sources, defines);
+        const auto object_files = build_shared_objects(module(), name(), include_dirs, compiler_sources, defines, objects_key);
+
+        if (build_config().library_type == m03gagbhsmhr0naw0zpccv4gaq_cxx_toolchain::library_type_t::SHARED) {
+            return link_cli_against_stubs(object_files, objects_key, link_inputs);
+        }
+
+        return m03gagbhsmhr0naw0zpccv4gaq_cxx_toolchain::link_binary(
+            object_files,
+            link_inputs,
+            build_dir() / m03gagbhsnusi43zogoacgj2ez_filesystem::relative_path_t("cli")
+        );
+    }
+
     return m03gagbhsmhr0naw0zpccv4gaq_cxx_toolchain::build_binary(
         build_dir(),
-        include_dirs_from_outputs(interfaces),
+        include_tree(module().workspace().graph(), include_dirs_from_outputs(interfaces)),
         compiler_source_files(source_files),
         defines,
         link_inputs,
@@ -630,6 +2223,91 @@ m03gagbhsnusi43zogoacgj2ez_filesystem::path_t binary_phase_t::build_cli(
     );
 }
 
+/**
+ * Marker in the default CLI template that the module name is written after, and the room reserved for it.
+ * Module names are directory names, so NAME_MAX bounds them.
+ */
+static constexpr std::string_view DEFAULT_CLI_MARKER = "builder-default-cli-module-name:";
+static constexpr std::size_t DEFAULT_CLI_NAME_CAPACITY = 256;
+
+static std::string default_cli_source() {
+    std::ostringstream oss;
+    oss
+        << "#include <cstddef>\n"
+        << "#include <iostream>\n"
+        << "#include <string>\n"
+        << "\n"
+        << "static volatile char module_name[" << DEFAULT_CLI_MARKER.size() + DEFAULT_CLI_NAME_CAPACITY << "] = " << cxx_string_literal(DEFAULT_CLI_MARKER) << ";\n"
+        << "\n"
+        << "int main() {\n"
+        << "    std::string name;\n"
+        << "    for (std::size_t i = " << DEFAULT_CLI_MARKER.size() << "; i < sizeof(module_name) && module_name[i] != '\\0'; ++i) {\n"
+        << "        name.push_back(module_name[i]);\n"
+        << "    }\n"
+        << "    std::cout << name << std::endl;\n"
+        << "    return 0;\n"
+        << "}\n";
+    return oss.str();
+}
+
+/**
+ * Generic default CLI shared by every module that installs none: <artifact_root>/default_cli/<key>/default_cli.
+ *
+ * Built once per key, which hashes the template source and the bootstrap seed version, so a toolchain change
+ * rebuilds it. Modules install a copy with their name patched over the placeholder instead of compiling one each.
+ */
+static m03gagbhsnusi43zogoacgj2ez_filesystem::path_t default_cli_template(const m03gagbhsp2drqq3gkop8pzfrm_workspace_graph::workspace_graph_t& workspace_graph) {
+    const auto source = default_cli_source();
+
+    fingerprint_t fingerprint;
+    fingerprint.mix(source);
+    fingerprint.mix(workspace_graph.bootstrap_seed_module().version().value);
+    const auto key = m03gagbhsnusi43zogoacgj2ez_filesystem::relative_path_t(std::to_string(fingerprint.value()));
+
+    const auto result = workspace_graph.artifact_root() / m03gagbhsnusi43zogoacgj2ez_filesystem::relative_path_t(DEFAULT_CLI_DIR) / key / m03gagbhsnusi43zogoacgj2ez_filesystem::relative_path_t("default_cli");
+    if (m03gagbhsnusi43zogoacgj2ez_filesystem::exists(result)) {
+        return result;
+    }
+
+    // The build dir is shared by every process building this key, so only one may write and link in it.
+    scoped_phase_lock_t template_lock(result);
+
+    // Another process may have built the template while this one waited for the lock.
+    if (m03gagbhsnusi43zogoacgj2ez_filesystem::exists(result)) {
+        return result;
+    }
+
+    const auto build_dir = workspace_graph.scratch_root() / m03gagbhsnusi43zogoacgj2ez_filesystem::relative_path_t(DEFAULT_CLI_DIR) / key / m03gagbhsnusi43zogoacgj2ez_filesystem::relative_path_t("build");
+    const auto source_relative_path = m03gagbhsnusi43zogoacgj2ez_filesystem::relative_path_t("default_cli.cpp");
+    const auto source_path = build_dir / source_relative_path;
+    m03gagbhsnusi43zogoacgj2ez_filesystem::create_directories(build_dir);
+    {
+        std::ofstream ofs(source_path.string(), std::ios::binary | std::ios::trunc);
+        if (!(ofs << source)) {
+            throw std::runtime_error(std::format("m03gagbhsujjf63n0w3r2w4q6h_build_phases::default_cli_template: failed to write default CLI source '{}'", source_path));
+        }
+    }
+
+    const auto binary = m03gagbhsmhr0naw0zpccv4gaq_cxx_toolchain::build_binary(
+        build_dir,
+        {},
+        { m03gagbhsnusi43zogoacgj2ez_filesystem::rooted_path_t(build_dir, source_relative_path) },
+        {},
+        m03gagbhsmhr0naw0zpccv4gaq_cxx_toolchain::link_inputs_t {},
+        build_dir / m03gagbhsnusi43zogoacgj2ez_filesystem::relative_path_t("default_cli")
+    );
+
+    // Readers that find the template without taking the lock never see a partial copy.
+    const auto result_tmp = result + std::format(".{}_tmp", ::getpid());
+    m03gagbhsnusi43zogoacgj2ez_filesystem::copy(binary, result_tmp);
+    m03gagbhsnusi43zogoacgj2ez_filesystem::rename_replace(result_tmp, result);
+    if (has_separate_scratch_root(workspace_graph)) {
+        m03gagbhsnusi43zogoacgj2ez_filesystem::remove_all(build_dir);
+    }
+
+    return result;
+}
+
 void binary_phase_t::install_cli(const m03gagbhsnusi43zogoacgj2ez_filesystem::path_t& binary) const {
     const auto binary_build_dir = build_dir();
 
@@ -655,55 +2333,71 @@ void binary_phase_t::finalize_install() const {
         return ;
     }
 
-    const auto source_relative_path = m03gagbhsnusi43zogoacgj2ez_filesystem::relative_path_t("default_cli.cpp");
-    const auto source_path = build_dir() / source_relative_path;
-    {
-        std::ofstream ofs(source_path.string(), std::ios::binary | std::ios::trunc);
-        if (!ofs) {
-            throw std::runtime_error(std::format("m03gagbhsujjf63n0w3r2w4q6h_build_phases::binary_phase_t::finalize_install: failed to write default CLI source '{}'", source_path));
-        }
+    const auto module_name = module().name().string();
+    if (DEFAULT_CLI_NAME_CAPACITY <= module_name.size()) {
+        throw std::runtime_error(std::format("m03gagbhsujjf63n0w3r2w4q6h_build_phases::binary_phase_t::finalize_install: module name '{}' does not fit the default CLI", module_name));
+    }
 
-        ofs
-            << "#include <iostream>\n"
-            << "\n"
-            << "int main() {\n"
-            << "    std::cout << " << cxx_string_literal(module().name().string()) << " << std::endl;\n"
-            << "    return 0;\n"
-            << "}\n";
-        if (!ofs) {
-            throw std::runtime_error(std::format("m03gagbhsujjf63n0w3r2w4q6h_build_phases::binary_phase_t::finalize_install: failed to write default CLI source '{}'", source_path));
-        }
+    const auto binary = build_dir() / m03gagbhsnusi43zogoacgj2ez_filesystem::relative_path_t("default_cli");
+    m03gagbhsnusi43zogoacgj2ez_filesystem::copy(default_cli_template(module().workspace().graph()), binary);
+
+    std::fstream fs(binary.string(), std::ios::binary | std::ios::in | std::ios::out);
+    const std::string contents((std::istreambuf_iterator<char>(fs)), std::istreambuf_iterator<char>());
+    const auto marker = contents.find(DEFAULT_CLI_MARKER);
+    if (marker == std::string::npos || contents.find(DEFAULT_CLI_MARKER, marker + 1) != std::string::npos) {
+        throw std::runtime_error(std::format("m03gagbhsujjf63n0w3r2w4q6h_build_phases::binary_phase_t::finalize_install: expected one module name placeholder in '{}'", binary));
+    }
+
+    fs.clear();
+    fs.seekp(static_cast<std::streamoff>(marker + DEFAULT_CLI_MARKER.size()));
+    fs.write(module_name.c_str(), static_cast<std::streamsize>(module_name.size() + 1));
+    fs.close();
+    if (!fs) {
+        throw std::runtime_error(std::format("m03gagbhsujjf63n0w3r2w4q6h_build_phases::binary_phase_t::finalize_install: failed to write module name into '{}'", binary));
     }
 
-    const auto binary = m03gagbhsmhr0naw0zpccv4gaq_cxx_toolchain::build_binary(
-        build_dir(),
-        {},
-        { m03gagbhsnusi43zogoacgj2ez_filesystem::rooted_path_t(build_dir(), source_relative_path) },
-        {},
-        m03gagbhsmhr0naw0zpccv4gaq_cxx_toolchain::link_inputs_t {},
-        build_dir() / m03gagbhsnusi43zogoacgj2ez_filesystem::relative_path_t("default_cli")
-    );
     install_cli(binary);
 }
 
 template <class phase_t>
 typename phase_t::installed_t phase_base_t::install(const phase_t& requested_phase) const {
+    auto key = phase_key(requested_phase.module(), requested_phase.name(), requested_phase.keyed_library_type());
+    if (const auto it = completed_phases().find(key); it != completed_phases().end()) {
+        return typename phase_t::installed_t(it->second);
+    }
+
     const auto build_dir = requested_phase.build_dir();
     const auto install_dir = requested_phase.install_dir();
-    const auto marker_path = [&](std::string_view state) {
-        return build_dir / m03gagbhsnusi43zogoacgj2ez_filesystem::relative_path_t(std::format("{}.{}", requested_phase.name(), state));
-    };
-    const auto started_marker = marker_path("started");
-    const auto complete_marker = marker_path("complete");
-
-    if (m03gagbhsnusi43zogoacgj2ez_filesystem::exists(complete_marker)) {
-        return typename phase_t::installed_t(requested_phase.install_dir());
+    const auto fingerprint = requested_phase.input_fingerprint();
+
+    // Source snapshots may be hard links to workspace files, so an in-place edit since the snapshot was taken
+    // must force a rebuild rather than leak into this version. Later phases install blob copies.
+    constexpr bool verify_contents = std::is_same_v<phase_t, source_phase_t>;
+    if (has_manifest(install_dir, fingerprint, verify_contents)) {
+        completed_phases().emplace(std::move(key), install_dir);
+        return typename phase_t::installed_t(install_dir);
     }
 
-    if (m03gagbhsnusi43zogoacgj2ez_filesystem::exists(started_marker)) {
+    scoped_install_lock_t install_lock(m_module.workspace().graph().artifact_root());
+    if (!started_phases().insert(key).second) {
         throw std::runtime_error(std::format("m03gagbhsujjf63n0w3r2w4q6h_build_phases::phase_base_t::install: re-entry detected for phase '{}'", requested_phase.name()));
     }
 
+    std::optional<scoped_phase_lock_t> phase_lock;
+    try {
+        phase_lock.emplace(install_dir);
+    } catch (...) {
+        started_phases().erase(key);
+        throw ;
+    }
+
+    // Another process may have installed the phase while this one waited for the lock.
+    if (has_manifest(install_dir, fingerprint, verify_contents)) {
+        started_phases().erase(key);
+        completed_phases().emplace(std::move(key), install_dir);
+        return typename phase_t::installed_t(install_dir);
+    }
+
     if (m03gagbhsnusi43zogoacgj2ez_filesystem::exists(build_dir)) {
         m03gagbhsnusi43zogoacgj2ez_filesystem::remove_all(build_dir);
     }
@@ -718,15 +2412,16 @@ typename phase_t::installed_t phase_base_t::install(const phase_t& requested_pha
             if (!m03gagbhsnusi43zogoacgj2ez_filesystem::exists(build_dir)) {
                 m03gagbhsnusi43zogoacgj2ez_filesystem::create_directories(build_dir);
             }
-            m03gagbhsnusi43zogoacgj2ez_filesystem::touch(started_marker);
             m03gagbhsnusi43zogoacgj2ez_filesystem::create_directories(install_dir);
 
+            const auto builder_plugin = requested_phase.builder_plugin();
             m03gagbhsx4j5z28bqkac3dhhh_shared_library::loader_t loader(
-                requested_phase.builder_plugin(),
+                builder_plugin,
                 m03gagbhsx4j5z28bqkac3dhhh_shared_library::lifetime_t::PROCESS,
                 m03gagbhsx4j5z28bqkac3dhhh_shared_library::symbol_resolution_t::LAZY,
                 m03gagbhsx4j5z28bqkac3dhhh_shared_library::symbol_visibility_t::LOCAL
             );
+            loaded_builder_plugins().insert(builder_plugin.string());
             const auto symbol_name = std::format("phase__{}", requested_phase.name());
             using fn_t = void (*)(const phase_t*);
             fn_t fn = loader.resolve(symbol_name.c_str());
@@ -739,7 +2434,7 @@ typename phase_t::installed_t phase_base_t::install(const phase_t& requested_pha
         const auto phase_artifact_dir = requested_phase.artifact_dir();
         const auto latest_dir = m_module.artifact_latest_dir();
         const auto latest_stage_dir = latest_dir / m_module.artifact_dir().relative(phase_artifact_dir);
-        const auto latest_stage_tmp_dir = latest_stage_dir + "_tmp";
+        const auto latest_stage_tmp_dir = latest_stage_dir + std::format(".{}_tmp", ::getpid());
 
         if (m03gagbhsnusi43zogoacgj2ez_filesystem::exists(latest_stage_tmp_dir)) {
             m03gagbhsnusi43zogoacgj2ez_filesystem::remove_all(latest_stage_tmp_dir);
@@ -752,11 +2447,19 @@ typename phase_t::installed_t phase_base_t::install(const phase_t& requested_pha
         m03gagbhsnusi43zogoacgj2ez_filesystem::create_directory_symlink(phase_artifact_dir, latest_stage_tmp_dir);
         m03gagbhsnusi43zogoacgj2ez_filesystem::rename_replace(latest_stage_tmp_dir, latest_stage_dir);
 
-        m03gagbhsnusi43zogoacgj2ez_filesystem::touch(complete_marker);
-        m03gagbhsnusi43zogoacgj2ez_filesystem::remove(started_marker);
+        // Earlier installs this phase ran for the first time are now part of its inputs.
+        write_manifest(install_dir, requested_phase.input_fingerprint());
+        installed_since_gc() = true;
+        if (has_separate_scratch_root(m_module.workspace().graph())) {
+            m03gagbhsnusi43zogoacgj2ez_filesystem::remove_all(build_dir);
+        }
+        started_phases().erase(key);
+        completed_phases().emplace(std::move(key), install_dir);
 
         return installed_result;
     } catch (...) {
+        started_phases().erase(key);
+        forget_installed_hashes(install_dir);
         m03gagbhsnusi43zogoacgj2ez_filesystem::remove_all(build_dir);
         m03gagbhsnusi43zogoacgj2ez_filesystem::remove_all(install_dir);
         throw ;
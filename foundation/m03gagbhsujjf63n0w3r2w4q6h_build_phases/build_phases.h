@@ -7,6 +7,7 @@
 
 # include <cstdint>
 # include <memory>
+# include <optional>
 # include <string>
 # include <string_view>
 # include <vector>
@@ -37,12 +38,105 @@ inline std::vector<phase_id_t> default_phase_order() {
 
 /**
  * Library kind and phase order for a build.
+ *
+ * With share_pic_objects, library and binary phases compile position-independent objects once per module version
+ * and compile inputs, and both library types archive or link the same objects.
  */
 struct build_config_t {
     m03gagbhsmhr0naw0zpccv4gaq_cxx_toolchain::library_type_t library_type;
     std::vector<phase_id_t> phase_order = default_phase_order();
+    bool share_pic_objects = false;
 };
 
+/**
+ * Build configuration fields a phase's outputs depend on.
+ *
+ * Configurations that differ only in fields a phase does not depend on share its build and install directories.
+ */
+struct config_dependencies_t {
+    bool library_type;
+};
+
+/**
+ * File published by a completed phase.
+ */
+struct manifest_entry_t {
+    m03gagbhsnusi43zogoacgj2ez_filesystem::relative_path_t relative_path;
+    uint64_t size;
+    uint64_t content_hash;
+};
+
+/**
+ * Record of a completed phase install, written atomically next to its install_dir().
+ *
+ * Its presence marks the phase complete. Entries are sorted by relative path.
+ */
+struct manifest_t {
+    /**
+     * Hash of the inputs the outputs were built from: source contents, the build configuration, and the
+     * manifests of earlier phases across the module's dependency closure.
+     */
+    uint64_t input_fingerprint;
+    std::vector<manifest_entry_t> entries;
+};
+
+/**
+ * Reads the manifest of a completed install_dir().
+ *
+ * Manifests never change once written, so each one is parsed at most once per process.
+ */
+const manifest_t& read_manifest(const m03gagbhsnusi43zogoacgj2ez_filesystem::path_t& install_dir);
+
+/**
+ * Forgets remembered completed phases and manifests whose files no longer exist, and returns whether there were any.
+ *
+ * For long-lived processes, such as the build server, whose artifact root may be cleaned behind their back.
+ */
+bool forget_missing_installs();
+
+/**
+ * Returns how many distinct builder plugins this process has loaded.
+ *
+ * Plugins are never unloaded, so a long-lived process accumulates one per module version it has built
+ * and should restart once this grows too large.
+ */
+std::size_t loaded_builder_plugin_count();
+
+/**
+ * Limits on what collect_garbage() keeps besides the versions `latest` points to and the newest builder plugin.
+ *
+ * Entries are ranked per module by when they were last built. Without limits none are kept.
+ */
+struct gc_policy_t {
+    std::optional<std::size_t> keep_versions;
+    std::optional<std::uintmax_t> max_bytes;
+};
+
+/**
+ * What collect_garbage() removed.
+ */
+struct gc_result_t {
+    std::size_t removed_dirs;
+    std::size_t removed_blobs;
+    std::uintmax_t removed_bytes;
+};
+
+/**
+ * Removes stale <module>@<version> directories and builder plugin builds under the invocation's artifact root,
+ * and build directories left under its scratch root by failed builds.
+ *
+ * Holds the artifact root lock exclusively, which phase installs hold shared, so it never races a build.
+ * Returns nullopt without removing anything when wait is false and a build holds the lock.
+ */
+std::optional<gc_result_t> collect_garbage(const m03gagbhsp2drqq3gkop8pzfrm_workspace_graph::invocation_context_t& invocation_context, const gc_policy_t& policy, bool wait);
+
+/**
+ * Applies <artifact_root>/gc_policy, if present, when this process installed a phase since the last call.
+ *
+ * Skips the collection instead of waiting for other builds.
+ */
+void collect_garbage_after_build(const m03gagbhsp2drqq3gkop8pzfrm_workspace_graph::invocation_context_t& invocation_context);
+
 /**
  * Common API available to every phase object.
  */
@@ -117,6 +211,7 @@ public:
 protected:
     phase_base_t(
         std::string_view name,
+        config_dependencies_t config_dependencies,
         m03gagbhsp2drqq3gkop8pzfrm_workspace_graph::module_t& module,
         build_config_t build_config,
         std::unique_ptr<phase_base_t> previous_phase
@@ -130,11 +225,19 @@ protected:
     std::vector<typename phase_t::installed_t> install_closure() const;
 
     void install_as(const m03gagbhsnusi43zogoacgj2ez_filesystem::path_t& path, const m03gagbhsnusi43zogoacgj2ez_filesystem::relative_path_t& relative_path) const;
+
+    /**
+     * Like install_as(), but may hard link a workspace file; the phase manifest is verified before each reuse.
+     */
+    void install_snapshot_as(const m03gagbhsnusi43zogoacgj2ez_filesystem::path_t& path, const m03gagbhsnusi43zogoacgj2ez_filesystem::relative_path_t& relative_path) const;
     m03gagbhsnusi43zogoacgj2ez_filesystem::relative_path_t installed_relative_path(const m03gagbhsnusi43zogoacgj2ez_filesystem::path_t& path) const;
     virtual void finalize_install() const;
 
 private:
     m03gagbhsnusi43zogoacgj2ez_filesystem::path_t artifact_dir() const;
+    m03gagbhsnusi43zogoacgj2ez_filesystem::path_t config_dir(const m03gagbhsnusi43zogoacgj2ez_filesystem::path_t& dir) const;
+    std::optional<m03gagbhsmhr0naw0zpccv4gaq_cxx_toolchain::library_type_t> keyed_library_type() const;
+    uint64_t input_fingerprint() const;
     m03gagbhsnusi43zogoacgj2ez_filesystem::path_t builder_plugin() const;
     const phase_base_t* previous_phase() const;
 
@@ -143,6 +246,7 @@ private:
 
 private:
     std::string_view m_name;
+    config_dependencies_t m_config_dependencies;
     m03gagbhsp2drqq3gkop8pzfrm_workspace_graph::module_t& m_module;
     build_config_t m_build_config;
     std::unique_ptr<phase_base_t> m_previous_phase;
@@ -165,6 +269,10 @@ struct source_phase_t : phase_base_t {
         m03gagbhsnusi43zogoacgj2ez_filesystem::path_t m_root;
     };
 
+    static constexpr config_dependencies_t config_dependencies {
+        .library_type = false
+    };
+
     source_phase_t(
         m03gagbhsp2drqq3gkop8pzfrm_workspace_graph::module_t& module,
         build_config_t build_config,
@@ -204,6 +312,10 @@ struct interface_phase_t : phase_base_t {
         m03gagbhsnusi43zogoacgj2ez_filesystem::path_t m_root;
     };
 
+    static constexpr config_dependencies_t config_dependencies {
+        .library_type = false
+    };
+
     interface_phase_t(
         m03gagbhsp2drqq3gkop8pzfrm_workspace_graph::module_t& module,
         build_config_t build_config,
@@ -250,6 +362,10 @@ struct library_phase_t : phase_base_t {
         m03gagbhsnusi43zogoacgj2ez_filesystem::path_t m_root;
     };
 
+    static constexpr config_dependencies_t config_dependencies {
+        .library_type = true
+    };
+
     library_phase_t(
         m03gagbhsp2drqq3gkop8pzfrm_workspace_graph::module_t& module,
         build_config_t build_config,
@@ -274,6 +390,12 @@ struct library_phase_t : phase_base_t {
      */
     void install_library(const m03gagbhsnusi43zogoacgj2ez_filesystem::path_t& library) const;
     void install_library(const phase_base_t::built_t& library) const;
+
+protected:
+    /**
+     * Writes the interface stub that binary links key on in place of the shared libraries themselves.
+     */
+    void finalize_install() const override;
 };
 
 /**
@@ -299,6 +421,10 @@ struct binary_phase_t : phase_base_t {
         m03gagbhsnusi43zogoacgj2ez_filesystem::path_t m_cli;
     };
 
+    static constexpr config_dependencies_t config_dependencies {
+        .library_type = true
+    };
+
     binary_phase_t(
         m03gagbhsp2drqq3gkop8pzfrm_workspace_graph::module_t& module,
         build_config_t build_config,
@@ -325,6 +451,17 @@ struct binary_phase_t : phase_base_t {
 
 protected:
     void finalize_install() const override;
+
+private:
+    /**
+     * Links the default CLI against shared libraries, or copies the previous build's when neither its objects
+     * nor the libraries' interface stubs changed, and points its run path at this build's libraries.
+     */
+    m03gagbhsnusi43zogoacgj2ez_filesystem::path_t link_cli_against_stubs(
+        const std::vector<m03gagbhsnusi43zogoacgj2ez_filesystem::path_t>& object_files,
+        uint64_t objects_key,
+        const m03gagbhsmhr0naw0zpccv4gaq_cxx_toolchain::link_inputs_t& link_inputs
+    ) const;
 };
 
 } // namespace m03gagbhsujjf63n0w3r2w4q6h_build_phases
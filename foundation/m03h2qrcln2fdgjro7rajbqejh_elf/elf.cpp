@@ -0,0 +1,233 @@
+#include "elf.h"
+
+#include <m03gagbhsnusi43zogoacgj2ez_filesystem/filesystem.h>
+
+#include <algorithm>
+#include <cstring>
+#include <format>
+#include <fstream>
+#include <iterator>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <elf.h>
+
+namespace m03h2qrcln2fdgjro7rajbqejh_elf {
+
+static std::string read_file(const m03gagbhsnusi43zogoacgj2ez_filesystem::path_t& path) {
+    std::ifstream ifs(path.to_native_path(), std::ios::binary);
+    if (!ifs) {
+        throw std::runtime_error(std::format("m03h2qrcln2fdgjro7rajbqejh_elf::read_file: failed to open file '{}'", path));
+    }
+
+    std::string result((std::istreambuf_iterator<char>(ifs)), std::istreambuf_iterator<char>());
+    if (ifs.bad()) {
+        throw std::runtime_error(std::format("m03h2qrcln2fdgjro7rajbqejh_elf::read_file: failed to read file '{}'", path));
+    }
+
+    return result;
+}
+
+template <class T>
+static T read_at(const std::string& contents, std::size_t offset, const m03gagbhsnusi43zogoacgj2ez_filesystem::path_t& path) {
+    if (contents.size() < offset || contents.size() - offset < sizeof(T)) {
+        throw std::runtime_error(std::format("m03h2qrcln2fdgjro7rajbqejh_elf::read_at: '{}' is truncated at offset {}", path, offset));
+    }
+
+    T result;
+    std::memcpy(&result, contents.data() + offset, sizeof(T));
+    return result;
+}
+
+/**
+ * Section headers of a 64-bit little-endian ELF file, the only kind the toolchain produces here.
+ */
+static std::vector<Elf64_Shdr> section_headers(const std::string& contents, const m03gagbhsnusi43zogoacgj2ez_filesystem::path_t& path) {
+    const auto header = read_at<Elf64_Ehdr>(contents, 0, path);
+    if (std::memcmp(header.e_ident, ELFMAG, SELFMAG) != 0) {
+        throw std::runtime_error(std::format("m03h2qrcln2fdgjro7rajbqejh_elf::section_headers: '{}' is not an ELF file", path));
+    }
+    if (header.e_ident[EI_CLASS] != ELFCLASS64 || header.e_ident[EI_DATA] != ELFDATA2LSB) {
+        throw std::runtime_error(std::format("m03h2qrcln2fdgjro7rajbqejh_elf::section_headers: '{}' is not a 64-bit little-endian ELF file", path));
+    }
+    if (header.e_shentsize != sizeof(Elf64_Shdr)) {
+        throw std::runtime_error(std::format("m03h2qrcln2fdgjro7rajbqejh_elf::section_headers: '{}' has unexpected section header size {}", path, header.e_shentsize));
+    }
+
+    std::vector<Elf64_Shdr> result;
+    result.reserve(header.e_shnum);
+    for (std::size_t i = 0; i < header.e_shnum; ++i) {
+        result.push_back(read_at<Elf64_Shdr>(contents, header.e_shoff + i * sizeof(Elf64_Shdr), path));
+    }
+
+    return result;
+}
+
+/**
+ * The only section of type in section_headers, or nullopt when there is none.
+ */
+static std::optional<Elf64_Shdr> find_section(
+    const std::vector<Elf64_Shdr>& sections,
+    Elf64_Word type,
+    const m03gagbhsnusi43zogoacgj2ez_filesystem::path_t& path
+) {
+    std::optional<Elf64_Shdr> result;
+    for (const auto& section : sections) {
+        if (section.sh_type != type) {
+            continue ;
+        }
+
+        if (result) {
+            throw std::runtime_error(std::format("m03h2qrcln2fdgjro7rajbqejh_elf::find_section: '{}' has more than one section of type {}", path, type));
+        }
+        result = section;
+    }
+
+    return result;
+}
+
+static const Elf64_Shdr& linked_section(
+    const std::vector<Elf64_Shdr>& sections,
+    const Elf64_Shdr& section,
+    const m03gagbhsnusi43zogoacgj2ez_filesystem::path_t& path
+) {
+    if (sections.size() <= section.sh_link) {
+        throw std::runtime_error(std::format("m03h2qrcln2fdgjro7rajbqejh_elf::linked_section: '{}' links to missing section {}", path, section.sh_link));
+    }
+
+    return sections[section.sh_link];
+}
+
+/**
+ * The NUL-terminated string at offset into string_table, excluding the terminator.
+ */
+static std::string_view string_at(
+    const std::string& contents,
+    const Elf64_Shdr& string_table,
+    std::size_t offset,
+    const m03gagbhsnusi43zogoacgj2ez_filesystem::path_t& path
+) {
+    if (contents.size() < string_table.sh_offset || contents.size() - string_table.sh_offset < string_table.sh_size || string_table.sh_size <= offset) {
+        throw std::runtime_error(std::format("m03h2qrcln2fdgjro7rajbqejh_elf::string_at: '{}' has no string at offset {}", path, offset));
+    }
+
+    const std::string_view strings(contents.data() + string_table.sh_offset, string_table.sh_size);
+    const auto end = strings.find('\0', offset);
+    if (end == std::string_view::npos) {
+        throw std::runtime_error(std::format("m03h2qrcln2fdgjro7rajbqejh_elf::string_at: '{}' has an unterminated string at offset {}", path, offset));
+    }
+
+    return strings.substr(offset, end - offset);
+}
+
+uint64_t abi_hash(const m03gagbhsnusi43zogoacgj2ez_filesystem::path_t& shared_library) {
+    const auto contents = read_file(shared_library);
+    const auto sections = section_headers(contents, shared_library);
+
+    const auto dynamic_symbols = find_section(sections, SHT_DYNSYM, shared_library);
+    if (!dynamic_symbols) {
+        throw std::runtime_error(std::format("m03h2qrcln2fdgjro7rajbqejh_elf::abi_hash: '{}' has no dynamic symbol table", shared_library));
+    }
+    if (dynamic_symbols->sh_entsize != sizeof(Elf64_Sym)) {
+        throw std::runtime_error(std::format("m03h2qrcln2fdgjro7rajbqejh_elf::abi_hash: '{}' has unexpected dynamic symbol size {}", shared_library, dynamic_symbols->sh_entsize));
+    }
+    const auto& symbol_names = linked_section(sections, *dynamic_symbols, shared_library);
+
+    std::vector<std::string> symbols;
+    // Entry 0 is the reserved undefined symbol.
+    for (std::size_t i = 1; i < dynamic_symbols->sh_size / sizeof(Elf64_Sym); ++i) {
+        const auto symbol = read_at<Elf64_Sym>(contents, dynamic_symbols->sh_offset + i * sizeof(Elf64_Sym), shared_library);
+        if (symbol.st_shndx == SHN_UNDEF) {
+            continue ;
+        }
+
+        const auto binding = ELF64_ST_BIND(symbol.st_info);
+        if (binding != STB_GLOBAL && binding != STB_WEAK && binding != STB_GNU_UNIQUE) {
+            continue ;
+        }
+
+        const auto visibility = ELF64_ST_VISIBILITY(symbol.st_other);
+        if (visibility != STV_DEFAULT && visibility != STV_PROTECTED) {
+            continue ;
+        }
+
+        // Executables reserve copy relocations for the data they reference, so data sizes are part of the interface.
+        const auto type = ELF64_ST_TYPE(symbol.st_info);
+        const auto size = type == STT_OBJECT || type == STT_TLS ? symbol.st_size : 0;
+
+        symbols.push_back(std::format(
+            "{} {} {} {} {}",
+            string_at(contents, symbol_names, symbol.st_name, shared_library),
+            static_cast<unsigned>(type),
+            static_cast<unsigned>(binding),
+            static_cast<unsigned>(visibility),
+            size
+        ));
+    }
+
+    std::sort(symbols.begin(), symbols.end());
+
+    std::uint64_t result = 0xcbf29ce484222325ull;
+    for (const auto& symbol : symbols) {
+        for (const char c : symbol) {
+            result ^= static_cast<unsigned char>(c);
+            result *= 0x100000001b3ull;
+        }
+        result ^= static_cast<unsigned char>('\n');
+        result *= 0x100000001b3ull;
+    }
+
+    return result;
+}
+
+void patch_runpath(const m03gagbhsnusi43zogoacgj2ez_filesystem::path_t& elf_file, std::string_view runpath) {
+    const auto contents = read_file(elf_file);
+    const auto sections = section_headers(contents, elf_file);
+
+    const auto dynamic = find_section(sections, SHT_DYNAMIC, elf_file);
+    if (!dynamic) {
+        throw std::runtime_error(std::format("m03h2qrcln2fdgjro7rajbqejh_elf::patch_runpath: '{}' has no dynamic section", elf_file));
+    }
+    const auto& dynamic_strings = linked_section(sections, *dynamic, elf_file);
+
+    std::optional<Elf64_Xword> runpath_offset;
+    for (std::size_t i = 0; i < dynamic->sh_size / sizeof(Elf64_Dyn); ++i) {
+        const auto entry = read_at<Elf64_Dyn>(contents, dynamic->sh_offset + i * sizeof(Elf64_Dyn), elf_file);
+        if (entry.d_tag == DT_NULL) {
+            break ;
+        }
+
+        // The loader ignores DT_RPATH when DT_RUNPATH is present.
+        if (entry.d_tag == DT_RUNPATH || (entry.d_tag == DT_RPATH && !runpath_offset)) {
+            runpath_offset = entry.d_un.d_val;
+        }
+    }
+
+    if (!runpath_offset) {
+        throw std::runtime_error(std::format("m03h2qrcln2fdgjro7rajbqejh_elf::patch_runpath: '{}' has no run path", elf_file));
+    }
+
+    const auto capacity = string_at(contents, dynamic_strings, *runpath_offset, elf_file).size();
+    if (capacity < runpath.size()) {
+        throw std::runtime_error(std::format("m03h2qrcln2fdgjro7rajbqejh_elf::patch_runpath: run path of {} bytes does not fit the {} bytes linked into '{}'", runpath.size(), capacity, elf_file));
+    }
+
+    std::string patched(runpath);
+    patched.resize(capacity, '\0');
+
+    std::fstream fs(elf_file.to_native_path(), std::ios::binary | std::ios::in | std::ios::out);
+    if (!fs) {
+        throw std::runtime_error(std::format("m03h2qrcln2fdgjro7rajbqejh_elf::patch_runpath: failed to open file '{}'", elf_file));
+    }
+
+    fs.seekp(static_cast<std::streamoff>(dynamic_strings.sh_offset + *runpath_offset));
+    fs.write(patched.data(), static_cast<std::streamsize>(patched.size()));
+    fs.close();
+    if (!fs) {
+        throw std::runtime_error(std::format("m03h2qrcln2fdgjro7rajbqejh_elf::patch_runpath: failed to write run path into '{}'", elf_file));
+    }
+}
+
+} // namespace m03h2qrcln2fdgjro7rajbqejh_elf
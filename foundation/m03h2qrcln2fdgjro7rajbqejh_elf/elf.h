@@ -0,0 +1,29 @@
+#ifndef M03H2QRCLN2FDGJRO7RAJBQEJH_ELF_ELF_H
+# define M03H2QRCLN2FDGJRO7RAJBQEJH_ELF_ELF_H
+
+# include <m03gagbhsnusi43zogoacgj2ez_filesystem/filesystem.h>
+
+# include <cstdint>
+# include <string_view>
+
+namespace m03h2qrcln2fdgjro7rajbqejh_elf {
+
+/**
+ * Hashes the interface shared_library exports to its dependents: name, type, binding and visibility of every
+ * global or weak dynamic symbol it defines, and the size of data symbols, in name order.
+ *
+ * Code changes that keep these equal do not change how anything links against the library.
+ */
+uint64_t abi_hash(const m03gagbhsnusi43zogoacgj2ez_filesystem::path_t& shared_library);
+
+/**
+ * Overwrites the DT_RUNPATH, or DT_RPATH, string of elf_file in place with runpath.
+ *
+ * The string the linker wrote bounds the length, so link with a placeholder at least as long as any runpath
+ * patched in later. Throws when elf_file has no run path or runpath does not fit.
+ */
+void patch_runpath(const m03gagbhsnusi43zogoacgj2ez_filesystem::path_t& elf_file, std::string_view runpath);
+
+} // namespace m03h2qrcln2fdgjro7rajbqejh_elf
+
+#endif // M03H2QRCLN2FDGJRO7RAJBQEJH_ELF_ELF_H
@@ -44,8 +44,8 @@ static std::string validate_name(std::string_view name) {
     return std::string(name);
 }
 
-static std::string uuidv7_base36_prefix() {
-    auto encoded = base36::encode(uuidv7::uuidv7::generate().bytes());
+static std::string uuidv7_base36_prefix(const uuidv7::uuidv7& uuid) {
+    auto encoded = base36::encode(uuid.bytes());
     if (UUIDV7_BASE36_WIDTH < encoded.size()) {
         throw std::runtime_error(std::format(
             "create_module: UUIDv7 base36 value '{}' is wider than {} characters",
@@ -242,7 +242,11 @@ static std::string builder_source(std::string_view module_name) {
 }
 
 std::string make_module_name(std::string_view name) {
-    return std::format("m{}_{}", uuidv7_base36_prefix(), validate_name(name));
+    return make_module_name(uuidv7::uuidv7::generate(), name);
+}
+
+std::string make_module_name(const uuidv7::uuidv7& uuid, std::string_view name) {
+    return std::format("m{}_{}", uuidv7_base36_prefix(uuid), validate_name(name));
 }
 
 created_module_t create(std::string_view workspace, std::string_view name) {
@@ -2,6 +2,7 @@
 # define M03GAGBHT5685JFNOKVJ7CRV2C_CREATE_MODULE_CREATE_MODULE_H
 
 # include <m03gagbhsnusi43zogoacgj2ez_filesystem/filesystem.h>
+# include <m03gagbhtft23yhjwpp881tfmc_uuidv7/uuidv7.h>
 
 # include <string>
 # include <string_view>
@@ -21,6 +22,11 @@ struct created_module_t {
  */
 std::string make_module_name(std::string_view name);
 
+/**
+ * Returns a module name with uuid as its prefix and validated slug.
+ */
+std::string make_module_name(const uuidv7::uuidv7& uuid, std::string_view name);
+
 /**
  * Creates a boilerplate module under workspace and returns its name and path.
  */
@@ -81,6 +81,12 @@ uuidv7 uuidv7::generate() {
         random_b = last_random_b;
     }
 
+    return from_fields(timestamp_millis, random_a, random_b);
+}
+
+uuidv7 uuidv7::from_fields(std::uint64_t timestamp_millis, std::uint16_t random_a, std::uint64_t random_b) {
+    std::array<std::uint8_t, 16> array;
+
     for (std::size_t i = 0; i < 6; ++i) {
         array[i] = static_cast<std::uint8_t>((timestamp_millis >> ((5 - i) * 8)) & 0xFF);
     }
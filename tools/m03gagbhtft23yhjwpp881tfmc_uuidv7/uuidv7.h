@@ -17,6 +17,13 @@ public:
      */
     static uuidv7 generate();
 
+    /**
+     * Packs an RFC 9562 UUIDv7 from its fields without consulting the clock or random source.
+     *
+     * Keeps the low 48 bits of timestamp_millis, 12 bits of random_a and 62 bits of random_b.
+     */
+    static uuidv7 from_fields(std::uint64_t timestamp_millis, std::uint16_t random_a, std::uint64_t random_b);
+
     /**
      * Returns the 16-byte UUID representation.
      */
@@ -0,0 +1,42 @@
+#include <m03h2q4zozpqzmnfnlnisqg61r_discover_benchmark/discover_benchmark.h>
+
+#include <m03gagbhsnusi43zogoacgj2ez_filesystem/filesystem.h>
+#include <m03gagbhsp2drqq3gkop8pzfrm_workspace_graph/workspace_graph.h>
+#include <m03h2q9ls4uyu360mrc9ao9uug_synthetic_workspace/synthetic_workspace.h>
+
+#include <exception>
+#include <filesystem>
+#include <format>
+#include <iostream>
+#include <string>
+
+int main(int argc, char** argv) {
+    if (argc != 3) {
+        std::cerr << "usage: " << argv[0] << " <fixture-root> <repetitions>\n"
+                  << "The fixture is a workspace written by the synthetic_workspace tool; a relative root is resolved against the workspace root.\n";
+        return 1;
+    }
+
+    try {
+        const auto invocation_context = m03gagbhsp2drqq3gkop8pzfrm_workspace_graph::invocation_context();
+        const auto fixture_root = std::filesystem::path(argv[1]).is_absolute()
+            ? m03gagbhsnusi43zogoacgj2ez_filesystem::path_t(argv[1])
+            : invocation_context.workspace_root / m03gagbhsnusi43zogoacgj2ez_filesystem::relative_path_t(argv[1]);
+        const auto repetitions = std::stoull(argv[2]);
+
+        const auto fixture = synthetic_workspace::load(fixture_root);
+        const auto timing = discover_benchmark::time_discover(
+            fixture.root,
+            m03gagbhsp2drqq3gkop8pzfrm_workspace_graph::module_name_t(fixture.root_module),
+            repetitions
+        );
+
+        std::cout << std::format("modules: {}", timing.modules) << std::endl;
+        std::cout << std::format("discover_module: min {:.3f} ms, median {:.3f} ms, max {:.3f} ms", timing.min_ms, timing.median_ms, timing.max_ms) << std::endl;
+    } catch (const std::exception& e) {
+        std::cerr << std::format("{}: {}", argv[0], e.what()) << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,45 @@
+#include <m03h2q4zozpqzmnfnlnisqg61r_discover_benchmark/discover_benchmark.h>
+
+#include <algorithm>
+#include <chrono>
+#include <stdexcept>
+#include <vector>
+
+namespace discover_benchmark {
+
+timing_t time_discover(
+    const m03gagbhsnusi43zogoacgj2ez_filesystem::path_t& workspace_root,
+    const m03gagbhsp2drqq3gkop8pzfrm_workspace_graph::module_name_t& target_module,
+    std::size_t repetitions
+) {
+    if (repetitions == 0) {
+        throw std::runtime_error("discover_benchmark::time_discover: repetitions must be positive");
+    }
+
+    const auto artifact_root = workspace_root / m03gagbhsnusi43zogoacgj2ez_filesystem::relative_path_t("artifacts");
+
+    std::size_t modules = 0;
+    std::vector<double> samples;
+    samples.reserve(repetitions);
+    for (std::size_t i = 0; i < repetitions; ++i) {
+        const auto start = std::chrono::steady_clock::now();
+
+        m03gagbhsp2drqq3gkop8pzfrm_workspace_graph::workspace_graph_t workspace_graph(workspace_root, artifact_root);
+        workspace_graph.discover_module(target_module);
+
+        const auto elapsed = std::chrono::steady_clock::now() - start;
+        samples.push_back(std::chrono::duration<double, std::milli>(elapsed).count());
+        modules = workspace_graph.modules().size();
+    }
+
+    std::sort(samples.begin(), samples.end());
+
+    return timing_t {
+        .modules = modules,
+        .min_ms = samples.front(),
+        .median_ms = samples[samples.size() / 2],
+        .max_ms = samples.back()
+    };
+}
+
+} // namespace discover_benchmark
@@ -0,0 +1,32 @@
+#ifndef M03H2Q4ZOZPQZMNFNLNISQG61R_DISCOVER_BENCHMARK_DISCOVER_BENCHMARK_H
+# define M03H2Q4ZOZPQZMNFNLNISQG61R_DISCOVER_BENCHMARK_DISCOVER_BENCHMARK_H
+
+# include <m03gagbhsnusi43zogoacgj2ez_filesystem/filesystem.h>
+# include <m03gagbhsp2drqq3gkop8pzfrm_workspace_graph/workspace_graph.h>
+
+# include <cstddef>
+
+namespace discover_benchmark {
+
+/**
+ * Wall-clock milliseconds of repeated discover_module calls.
+ */
+struct timing_t {
+    std::size_t modules;
+    double min_ms;
+    double median_ms;
+    double max_ms;
+};
+
+/**
+ * Discovers target_module repetitions times, each in a fresh workspace_graph_t.
+ */
+timing_t time_discover(
+    const m03gagbhsnusi43zogoacgj2ez_filesystem::path_t& workspace_root,
+    const m03gagbhsp2drqq3gkop8pzfrm_workspace_graph::module_name_t& target_module,
+    std::size_t repetitions
+);
+
+} // namespace discover_benchmark
+
+#endif // M03H2Q4ZOZPQZMNFNLNISQG61R_DISCOVER_BENCHMARK_DISCOVER_BENCHMARK_H
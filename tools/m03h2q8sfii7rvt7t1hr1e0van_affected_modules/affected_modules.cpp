@@ -0,0 +1,109 @@
+#include <m03h2q8sfii7rvt7t1hr1e0van_affected_modules/affected_modules.h>
+
+#include <algorithm>
+#include <string>
+#include <unordered_set>
+
+namespace affected_modules {
+
+static const m03gagbhsp2drqq3gkop8pzfrm_workspace_graph::module_t* owning_module(
+    const m03gagbhsp2drqq3gkop8pzfrm_workspace_graph::workspace_graph_t& workspace_graph,
+    const m03gagbhsnusi43zogoacgj2ez_filesystem::path_t& path
+) {
+    for (const auto* workspace : workspace_graph.workspaces()) {
+        const auto workspace_dir = workspace_graph.root() / workspace->relative_path();
+        if (!workspace_dir.is_child(path)) {
+            continue ;
+        }
+
+        const auto module_name = workspace_dir.relative(path).to_native_path().begin()->string();
+        if (const auto* module = workspace->find_module(m03gagbhsp2drqq3gkop8pzfrm_workspace_graph::module_name_t(module_name)); module != nullptr) {
+            return module;
+        }
+    }
+
+    return nullptr;
+}
+
+affected_t find_affected(
+    m03gagbhsp2drqq3gkop8pzfrm_workspace_graph::workspace_graph_t& workspace_graph,
+    const std::vector<m03gagbhsnusi43zogoacgj2ez_filesystem::path_t>& changed_paths
+) {
+    workspace_graph.discover_all_modules();
+
+    const auto workspaces_json = workspace_graph.root() / m03gagbhsnusi43zogoacgj2ez_filesystem::relative_path_t(m03gagbhsp2drqq3gkop8pzfrm_workspace_graph::WORKSPACES_JSON);
+
+    affected_t result;
+    std::unordered_set<const m03gagbhsp2drqq3gkop8pzfrm_workspace_graph::module_t*> changed_modules;
+    for (const auto& changed_path : changed_paths) {
+        if (changed_path == workspaces_json) {
+            for (const auto* module : workspace_graph.modules()) {
+                changed_modules.insert(module);
+            }
+            continue ;
+        }
+
+        if (const auto* module = owning_module(workspace_graph, changed_path); module != nullptr) {
+            changed_modules.insert(module);
+        } else {
+            result.unowned_paths.push_back(changed_path);
+        }
+    }
+
+    // No module version is below the bootstrap seed's, which covers every module the seed reaches.
+    const auto& bootstrap_seed_module = workspace_graph.bootstrap_seed_module();
+    const bool bootstrap_seed_changed = std::any_of(changed_modules.begin(), changed_modules.end(), [&](const m03gagbhsp2drqq3gkop8pzfrm_workspace_graph::module_t* module) {
+        return workspace_graph.reaches(bootstrap_seed_module, *module);
+    });
+
+    std::unordered_set<const m03gagbhsp2drqq3gkop8pzfrm_workspace_graph::module_t*> dependent_modules;
+    if (bootstrap_seed_changed) {
+        for (const auto* module : workspace_graph.modules()) {
+            if (!changed_modules.contains(module)) {
+                dependent_modules.insert(module);
+            }
+        }
+    } else {
+        for (const auto* module : changed_modules) {
+            for (const auto* dependent : workspace_graph.dependents(*module)) {
+                if (!changed_modules.contains(dependent)) {
+                    dependent_modules.insert(dependent);
+                }
+            }
+        }
+    }
+
+    for (const auto* module : workspace_graph.modules()) {
+        if (changed_modules.contains(module)) {
+            result.modules.push_back(affected_module_t { .module = module, .changed = true });
+        } else if (dependent_modules.contains(module)) {
+            result.modules.push_back(affected_module_t { .module = module, .changed = false });
+        }
+    }
+
+    return result;
+}
+
+std::vector<const m03gagbhsp2drqq3gkop8pzfrm_workspace_graph::module_t*> build_targets(
+    const m03gagbhsp2drqq3gkop8pzfrm_workspace_graph::workspace_graph_t& workspace_graph,
+    const affected_t& affected
+) {
+    std::vector<const m03gagbhsp2drqq3gkop8pzfrm_workspace_graph::module_t*> result;
+
+    for (const auto& candidate : affected.modules) {
+        // Modules in one strongly connected component reach each other; keep all of them rather than none.
+        const bool covered = std::any_of(affected.modules.begin(), affected.modules.end(), [&](const affected_module_t& other) {
+            return other.module != candidate.module
+                && workspace_graph.reaches(*other.module, *candidate.module)
+                && !workspace_graph.reaches(*candidate.module, *other.module);
+        });
+
+        if (!covered) {
+            result.push_back(candidate.module);
+        }
+    }
+
+    return result;
+}
+
+} // namespace affected_modules
@@ -0,0 +1,55 @@
+#ifndef M03H2Q8SFII7RVT7T1HR1E0VAN_AFFECTED_MODULES_AFFECTED_MODULES_H
+# define M03H2Q8SFII7RVT7T1HR1E0VAN_AFFECTED_MODULES_AFFECTED_MODULES_H
+
+# include <m03gagbhsnusi43zogoacgj2ez_filesystem/filesystem.h>
+# include <m03gagbhsp2drqq3gkop8pzfrm_workspace_graph/workspace_graph.h>
+
+# include <vector>
+
+namespace affected_modules {
+
+/**
+ * Module whose version changes with the changed paths.
+ *
+ * Every phase of an affected module rebuilds, since its artifact directory is keyed by version.
+ */
+struct affected_module_t {
+    const m03gagbhsp2drqq3gkop8pzfrm_workspace_graph::module_t* module;
+
+    /**
+     * True if a changed path is inside module's source_dir(); false if only a dependency changed.
+     */
+    bool changed;
+};
+
+/**
+ * Affected modules sorted by workspace order and name, and changed paths outside every module.
+ */
+struct affected_t {
+    std::vector<affected_module_t> modules;
+    std::vector<m03gagbhsnusi43zogoacgj2ez_filesystem::path_t> unowned_paths;
+};
+
+/**
+ * Maps changed_paths to modules through source_dir() and adds every module that reaches them
+ * through module or builder dependencies.
+ *
+ * Discovers every module in workspace_graph. A changed workspaces.json affects every module, and so does a
+ * change to the bootstrap seed or anything it reaches, since every module's version is at least the seed's.
+ */
+affected_t find_affected(
+    m03gagbhsp2drqq3gkop8pzfrm_workspace_graph::workspace_graph_t& workspace_graph,
+    const std::vector<m03gagbhsnusi43zogoacgj2ez_filesystem::path_t>& changed_paths
+);
+
+/**
+ * Minimal modules whose builds cover every affected module: those no other affected module depends on.
+ */
+std::vector<const m03gagbhsp2drqq3gkop8pzfrm_workspace_graph::module_t*> build_targets(
+    const m03gagbhsp2drqq3gkop8pzfrm_workspace_graph::workspace_graph_t& workspace_graph,
+    const affected_t& affected
+);
+
+} // namespace affected_modules
+
+#endif // M03H2Q8SFII7RVT7T1HR1E0VAN_AFFECTED_MODULES_AFFECTED_MODULES_H
@@ -0,0 +1,84 @@
+#include <m03h2q8sfii7rvt7t1hr1e0van_affected_modules/affected_modules.h>
+
+#include <m03gagbhsnusi43zogoacgj2ez_filesystem/filesystem.h>
+#include <m03gagbhsp2drqq3gkop8pzfrm_workspace_graph/workspace_graph.h>
+
+#include <exception>
+#include <filesystem>
+#include <format>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+static int usage(const char* program) {
+    std::cerr << "usage: " << program << " [--targets] [--] [changed-path...]\n"
+              << "Reads changed paths from stdin when none are given; relative paths are resolved against the workspace root.\n";
+    return 1;
+}
+
+int main(int argc, char** argv) {
+    bool targets_only = false;
+    std::vector<std::string> arguments;
+    bool options_ended = false;
+    for (int i = 1; i < argc; ++i) {
+        const std::string_view argument(argv[i]);
+        if (options_ended || !argument.starts_with("-")) {
+            arguments.emplace_back(argument);
+        } else if (argument == "--") {
+            options_ended = true;
+        } else if (argument == "--targets") {
+            targets_only = true;
+        } else if (argument == "--help") {
+            return usage(argv[0]);
+        } else {
+            std::cerr << std::format("{}: unknown option '{}'", argv[0], argument) << std::endl;
+            return usage(argv[0]);
+        }
+    }
+
+    try {
+        const auto invocation_context = m03gagbhsp2drqq3gkop8pzfrm_workspace_graph::invocation_context();
+        m03gagbhsp2drqq3gkop8pzfrm_workspace_graph::workspace_graph_t workspace_graph(
+            invocation_context.workspace_root,
+            invocation_context.artifact_root
+        );
+
+        if (arguments.empty()) {
+            for (std::string line; std::getline(std::cin, line);) {
+                if (!line.empty()) {
+                    arguments.push_back(line);
+                }
+            }
+        }
+
+        std::vector<m03gagbhsnusi43zogoacgj2ez_filesystem::path_t> changed_paths;
+        for (const auto& argument : arguments) {
+            if (std::filesystem::path(argument).is_absolute()) {
+                changed_paths.emplace_back(argument);
+            } else {
+                changed_paths.push_back(invocation_context.workspace_root / m03gagbhsnusi43zogoacgj2ez_filesystem::relative_path_t(argument));
+            }
+        }
+
+        const auto affected = affected_modules::find_affected(workspace_graph, changed_paths);
+        for (const auto& unowned_path : affected.unowned_paths) {
+            std::cerr << std::format("{}: path '{}' is not inside a module", argv[0], unowned_path) << std::endl;
+        }
+
+        if (targets_only) {
+            for (const auto* module : affected_modules::build_targets(workspace_graph, affected)) {
+                std::cout << module->name().string() << std::endl;
+            }
+        } else {
+            for (const auto& affected_module : affected.modules) {
+                std::cout << std::format("{} {}", affected_module.changed ? "changed" : "dependent", affected_module.module->name()) << std::endl;
+            }
+        }
+    } catch (const std::exception& e) {
+        std::cerr << std::format("{}: {}", argv[0], e.what()) << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,78 @@
+#include <m03h2q9ls4uyu360mrc9ao9uug_synthetic_workspace/synthetic_workspace.h>
+
+#include <m03gagbhsnusi43zogoacgj2ez_filesystem/filesystem.h>
+#include <m03gagbhsp2drqq3gkop8pzfrm_workspace_graph/workspace_graph.h>
+
+#include <exception>
+#include <filesystem>
+#include <format>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+static void usage(const char* program) {
+    std::cerr << "usage: " << program << " <new-workspace-root> [options]\n"
+              << "  --modules <n>             synthetic module count (default 1000)\n"
+              << "  --fan-out <n>             dependencies on earlier modules per module (default 4)\n"
+              << "  --fan-in <n>              maximum dependents per module, 0 for unbounded (default 0)\n"
+              << "  --scc-size <n>            modules per dependency cycle (default 1)\n"
+              << "  --layers <n>              synthetic workspaces (default 1)\n"
+              << "  --sources <n>             .cpp files per module (default 1)\n"
+              << "  --headers <n>             headers per module (default 1)\n"
+              << "  --header-weight <n>       inline functions per header (default 8)\n"
+              << "  --seed <n>                name and dependency seed (default 1)\n"
+              << "A relative root is resolved against the workspace root.\n";
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2 || argc % 2 != 0 || std::string_view(argv[1]).starts_with("--")) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    try {
+        synthetic_workspace::shape_t shape;
+        for (int i = 2; i < argc; i += 2) {
+            const std::string_view option = argv[i];
+            const auto value = std::stoull(argv[i + 1]);
+            if (option == "--modules") {
+                shape.modules = value;
+            } else if (option == "--fan-out") {
+                shape.fan_out = value;
+            } else if (option == "--fan-in") {
+                shape.fan_in = value;
+            } else if (option == "--scc-size") {
+                shape.scc_size = value;
+            } else if (option == "--layers") {
+                shape.layers = value;
+            } else if (option == "--sources") {
+                shape.sources_per_module = value;
+            } else if (option == "--headers") {
+                shape.headers_per_module = value;
+            } else if (option == "--header-weight") {
+                shape.header_weight = value;
+            } else if (option == "--seed") {
+                shape.seed = value;
+            } else {
+                throw std::runtime_error(std::format("unknown option '{}'", option));
+            }
+        }
+
+        const auto invocation_context = m03gagbhsp2drqq3gkop8pzfrm_workspace_graph::invocation_context();
+        const auto output_root = std::filesystem::path(argv[1]).is_absolute()
+            ? m03gagbhsnusi43zogoacgj2ez_filesystem::path_t(argv[1])
+            : invocation_context.workspace_root / m03gagbhsnusi43zogoacgj2ez_filesystem::relative_path_t(argv[1]);
+
+        const auto generated = synthetic_workspace::generate(invocation_context.workspace_root, output_root, shape);
+
+        std::cout << std::format("workspace root: {}", generated.root) << std::endl;
+        std::cout << std::format("modules: {} in {} workspaces", generated.modules.size(), generated.workspaces.size() - 1) << std::endl;
+        std::cout << std::format("root module: {}", generated.root_module) << std::endl;
+    } catch (const std::exception& e) {
+        std::cerr << std::format("{}: {}", argv[0], e.what()) << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,424 @@
+#include <m03h2q9ls4uyu360mrc9ao9uug_synthetic_workspace/synthetic_workspace.h>
+
+#include <m03gagbhsp2drqq3gkop8pzfrm_workspace_graph/workspace_graph.h>
+#include <m03gagbhsqfsqblhwvelrou7nc_json/external/json.hpp>
+#include <m03gagbht5685jfnokvj7crv2c_create_module/create_module.h>
+#include <m03gagbhtft23yhjwpp881tfmc_uuidv7/uuidv7.h>
+
+#include <algorithm>
+#include <fstream>
+#include <format>
+#include <stdexcept>
+#include <string_view>
+
+namespace synthetic_workspace {
+
+static constexpr const char* SEED_WORKSPACE = "foundation";
+static constexpr const char* MODULE_SLUG = "synthetic";
+static constexpr const char* ROOT_MODULE_SLUG = "synthetic_root";
+
+// 2024-01-01T00:00:00Z; module i gets timestamp BASE_TIMESTAMP_MILLIS + i so names sort in generation order.
+static constexpr std::uint64_t BASE_TIMESTAMP_MILLIS = 1704067200000ULL;
+
+static const char* const BUILDER_DEPENDENCIES[] = {
+    "m03gagbhsujjf63n0w3r2w4q6h_build_phases",
+    "m03gagbhsnusi43zogoacgj2ez_filesystem",
+    "m03gagbhsp2drqq3gkop8pzfrm_workspace_graph"
+};
+
+/**
+ * splitmix64; keeps generation reproducible across standard library implementations.
+ */
+class random_t {
+public:
+    explicit random_t(std::uint64_t seed):
+        m_state(seed)
+    {
+    }
+
+    std::uint64_t next() {
+        std::uint64_t z = (m_state += 0x9E3779B97F4A7C15ULL);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        return z ^ (z >> 31);
+    }
+
+    std::size_t below(std::size_t bound) {
+        return static_cast<std::size_t>(next() % bound);
+    }
+
+private:
+    std::uint64_t m_state;
+};
+
+struct synthetic_module_t {
+    std::string name;
+    std::size_t layer;
+    std::vector<std::size_t> dependencies;
+};
+
+static std::string uppercase_identifier(std::string_view value) {
+    std::string result;
+    result.reserve(value.size());
+
+    for (const char c : value) {
+        if ('a' <= c && c <= 'z') {
+            result.push_back(static_cast<char>('A' + (c - 'a')));
+        } else {
+            result.push_back(c);
+        }
+    }
+
+    return result;
+}
+
+static void write_file(const m03gagbhsnusi43zogoacgj2ez_filesystem::path_t& path, std::string_view contents) {
+    std::ofstream ofs(path.string(), std::ios::binary | std::ios::trunc);
+    if (!ofs) {
+        throw std::runtime_error(std::format("synthetic_workspace::write_file: failed to open file '{}'", path));
+    }
+
+    ofs << contents;
+    if (!ofs) {
+        throw std::runtime_error(std::format("synthetic_workspace::write_file: failed to write file '{}'", path));
+    }
+}
+
+static std::string layer_workspace(std::size_t layer) {
+    return std::format("synthetic_{}", layer);
+}
+
+static void validate_shape(const shape_t& shape) {
+    if (shape.modules == 0) {
+        throw std::runtime_error("synthetic_workspace::generate: module count must be positive");
+    }
+    if (shape.scc_size == 0) {
+        throw std::runtime_error("synthetic_workspace::generate: scc size must be positive");
+    }
+    if (shape.layers == 0) {
+        throw std::runtime_error("synthetic_workspace::generate: layer count must be positive");
+    }
+    if (shape.sources_per_module == 0) {
+        throw std::runtime_error("synthetic_workspace::generate: sources per module must be positive");
+    }
+    if (shape.headers_per_module == 0) {
+        throw std::runtime_error("synthetic_workspace::generate: headers per module must be positive");
+    }
+}
+
+static std::vector<synthetic_module_t> make_modules(const shape_t& shape) {
+    random_t random(shape.seed);
+
+    const auto group_count = (shape.modules + shape.scc_size - 1) / shape.scc_size;
+    const auto layers = std::min(shape.layers, group_count);
+
+    std::vector<synthetic_module_t> result;
+    result.reserve(shape.modules + 1);
+    for (std::size_t i = 0; i < shape.modules; ++i) {
+        const auto uuid = uuidv7::uuidv7::from_fields(BASE_TIMESTAMP_MILLIS + i, static_cast<std::uint16_t>(random.next()), random.next());
+        result.push_back(synthetic_module_t {
+            .name = create_module::make_module_name(uuid, MODULE_SLUG),
+            .layer = i / shape.scc_size * layers / group_count,
+            .dependencies = {}
+        });
+    }
+
+    // Modules of earlier groups that may still gain dependents under shape.fan_in.
+    std::vector<std::size_t> open;
+    std::vector<std::size_t> dependent_count(shape.modules, 0);
+    for (std::size_t group_begin = 0; group_begin < shape.modules; group_begin += shape.scc_size) {
+        const auto group_end = std::min(group_begin + shape.scc_size, shape.modules);
+
+        for (std::size_t i = group_begin; i < group_end; ++i) {
+            auto& dependencies = result[i].dependencies;
+            if (1 < group_end - group_begin) {
+                dependencies.push_back(i + 1 == group_end ? group_begin : i + 1);
+            }
+
+            // Partial Fisher-Yates over open picks distinct dependencies.
+            const auto picks = std::min(shape.fan_out, open.size());
+            for (std::size_t k = 0; k < picks; ++k) {
+                std::swap(open[k], open[k + random.below(open.size() - k)]);
+                dependencies.push_back(open[k]);
+                ++dependent_count[open[k]];
+            }
+
+            // Only the picked prefix gained dependents; drop the saturated ones by swapping with the back.
+            for (std::size_t k = picks; shape.fan_in != 0 && 0 < k; --k) {
+                if (shape.fan_in <= dependent_count[open[k - 1]]) {
+                    open[k - 1] = open.back();
+                    open.pop_back();
+                }
+            }
+        }
+
+        for (std::size_t i = group_begin; i < group_end; ++i) {
+            open.push_back(i);
+        }
+    }
+
+    // A group without dependents from later groups is only reachable from the root module.
+    synthetic_module_t root {
+        .name = create_module::make_module_name(uuidv7::uuidv7::from_fields(BASE_TIMESTAMP_MILLIS + shape.modules, 0, 0), ROOT_MODULE_SLUG),
+        .layer = layers - 1,
+        .dependencies = {}
+    };
+    for (std::size_t group_begin = 0; group_begin < shape.modules; group_begin += shape.scc_size) {
+        const auto group_end = std::min(group_begin + shape.scc_size, shape.modules);
+        const bool has_dependents = std::any_of(dependent_count.begin() + group_begin, dependent_count.begin() + group_end, [](std::size_t count) {
+            return count != 0;
+        });
+        if (!has_dependents) {
+            root.dependencies.push_back(group_begin);
+        }
+    }
+    result.push_back(std::move(root));
+
+    return result;
+}
+
+static std::string deps_json(const std::vector<synthetic_module_t>& modules, const synthetic_module_t& module) {
+    nlohmann::ordered_json json;
+    json["module_dependencies"] = nlohmann::ordered_json::array();
+    for (const auto dependency : module.dependencies) {
+        json["module_dependencies"].push_back(modules[dependency].name);
+    }
+    json["builder_dependencies"] = BUILDER_DEPENDENCIES;
+
+    return json.dump(4) + "\n";
+}
+
+static std::string header_source(const std::vector<synthetic_module_t>& modules, const synthetic_module_t& module, std::size_t header, const shape_t& shape) {
+    const auto guard = std::format("{}_H{}_H", uppercase_identifier(module.name), header);
+
+    std::string result = std::format("#ifndef {0}\n# define {0}\n\n", guard);
+    if (header == 0) {
+        for (const auto dependency : module.dependencies) {
+            result += std::format("# include <{}/h0.h>\n", modules[dependency].name);
+        }
+        if (!module.dependencies.empty()) {
+            result += "\n";
+        }
+    }
+
+    result += std::format("namespace {} {{\n\n", module.name);
+    if (header == 0) {
+        for (std::size_t source = 0; source < shape.sources_per_module; ++source) {
+            result += std::format("int s{}();\n", source);
+        }
+        result += "\n";
+    }
+    for (std::size_t function = 0; function < shape.header_weight; ++function) {
+        result += std::format(
+            "inline int h{0}_f{1}(int value) {{\n"
+            "    return value * {2} + {0};\n"
+            "}}\n"
+            "\n",
+            header,
+            function,
+            function + 3
+        );
+    }
+    result += std::format("}} // namespace {}\n\n#endif // {}\n", module.name, guard);
+
+    return result;
+}
+
+static std::string source_source(const std::vector<synthetic_module_t>& modules, const synthetic_module_t& module, std::size_t source, const shape_t& shape) {
+    std::string result;
+    for (std::size_t header = 0; header < shape.headers_per_module; ++header) {
+        result += std::format("#include <{}/h{}.h>\n", module.name, header);
+    }
+
+    result += std::format("\nnamespace {} {{\n\nint s{}() {{\n    int value = {};\n", module.name, source, source);
+    if (0 < shape.header_weight) {
+        for (std::size_t header = 0; header < shape.headers_per_module; ++header) {
+            result += std::format("    value = h{}_f0(value);\n", header);
+        }
+    }
+    if (source == 0) {
+        for (const auto dependency : module.dependencies) {
+            result += std::format("    value += {}::s0();\n", modules[dependency].name);
+        }
+    } else {
+        result += std::format("    value += s{}();\n", source - 1);
+    }
+    result += std::format("    return value;\n}}\n\n}} // namespace {}\n", module.name);
+
+    return result;
+}
+
+static std::string cli_source(const synthetic_module_t& module) {
+    return std::format(
+        "#include <iostream>\n"
+        "\n"
+        "int main() {{\n"
+        "    std::cout << \"{}\" << std::endl;\n"
+        "    return 0;\n"
+        "}}\n",
+        module.name
+    );
+}
+
+static std::string builder_source(const synthetic_module_t& module, const shape_t& shape) {
+    std::string sources;
+    for (std::size_t source = 0; source < shape.sources_per_module; ++source) {
+        sources += std::format(
+            "            phase->build(sources.root() / m03gagbhsnusi43zogoacgj2ez_filesystem::relative_path_t(\"s{}.cpp\")){}\n",
+            source,
+            source + 1 == shape.sources_per_module ? "" : ","
+        );
+    }
+
+    return std::format(
+        "#include <m03gagbhsujjf63n0w3r2w4q6h_build_phases/build_phases.h>\n"
+        "#include <m03gagbhsnusi43zogoacgj2ez_filesystem/filesystem.h>\n"
+        "#include <m03gagbhsp2drqq3gkop8pzfrm_workspace_graph/workspace_graph.h>\n"
+        "\n"
+        "namespace {0} {{\n"
+        "\n"
+        "extern \"C\" void phase__source(const m03gagbhsujjf63n0w3r2w4q6h_build_phases::source_phase_t* phase) {{\n"
+        "    phase->install_source_tree();\n"
+        "}}\n"
+        "\n"
+        "extern \"C\" void phase__interface(const m03gagbhsujjf63n0w3r2w4q6h_build_phases::interface_phase_t* phase) {{\n"
+        "    phase->install_headers_from_source();\n"
+        "}}\n"
+        "\n"
+        "extern \"C\" void phase__library(const m03gagbhsujjf63n0w3r2w4q6h_build_phases::library_phase_t* phase) {{\n"
+        "    const auto sources = phase->install<m03gagbhsujjf63n0w3r2w4q6h_build_phases::source_phase_t>();\n"
+        "    const auto library = phase->build_library(\n"
+        "        {{\n"
+        "{1}"
+        "        }},\n"
+        "        {{}}\n"
+        "    );\n"
+        "    phase->install_library(library);\n"
+        "}}\n"
+        "\n"
+        "extern \"C\" void phase__binary(const m03gagbhsujjf63n0w3r2w4q6h_build_phases::binary_phase_t* phase) {{\n"
+        "    const auto sources = phase->install<m03gagbhsujjf63n0w3r2w4q6h_build_phases::source_phase_t>();\n"
+        "    const auto cli = phase->build_cli(\n"
+        "        {{ phase->build(sources.root() / m03gagbhsnusi43zogoacgj2ez_filesystem::relative_path_t(m03gagbhsp2drqq3gkop8pzfrm_workspace_graph::CLI_CPP)) }},\n"
+        "        {{}}\n"
+        "    );\n"
+        "    phase->install_cli(cli);\n"
+        "}}\n"
+        "\n"
+        "}} // namespace {0}\n",
+        module.name,
+        sources
+    );
+}
+
+static void write_module(
+    const m03gagbhsnusi43zogoacgj2ez_filesystem::path_t& output_root,
+    const std::vector<synthetic_module_t>& modules,
+    const synthetic_module_t& module,
+    const shape_t& shape
+) {
+    const auto module_dir = output_root / m03gagbhsnusi43zogoacgj2ez_filesystem::relative_path_t(layer_workspace(module.layer)) / m03gagbhsnusi43zogoacgj2ez_filesystem::relative_path_t(module.name);
+    m03gagbhsnusi43zogoacgj2ez_filesystem::create_directories(module_dir);
+
+    write_file(module_dir / m03gagbhsnusi43zogoacgj2ez_filesystem::relative_path_t(m03gagbhsp2drqq3gkop8pzfrm_workspace_graph::MODULE_JSON), deps_json(modules, module));
+    for (std::size_t header = 0; header < shape.headers_per_module; ++header) {
+        write_file(module_dir / m03gagbhsnusi43zogoacgj2ez_filesystem::relative_path_t(std::format("h{}.h", header)), header_source(modules, module, header, shape));
+    }
+    for (std::size_t source = 0; source < shape.sources_per_module; ++source) {
+        write_file(module_dir / m03gagbhsnusi43zogoacgj2ez_filesystem::relative_path_t(std::format("s{}.cpp", source)), source_source(modules, module, source, shape));
+    }
+    write_file(module_dir / m03gagbhsnusi43zogoacgj2ez_filesystem::relative_path_t(m03gagbhsp2drqq3gkop8pzfrm_workspace_graph::CLI_CPP), cli_source(module));
+    write_file(module_dir / m03gagbhsnusi43zogoacgj2ez_filesystem::relative_path_t(m03gagbhsp2drqq3gkop8pzfrm_workspace_graph::BUILDER_CPP), builder_source(module, shape));
+}
+
+static std::string manifest_json(const shape_t& shape, const generated_t& generated) {
+    nlohmann::ordered_json json;
+    json["shape"] = {
+        { "modules", shape.modules },
+        { "fan_out", shape.fan_out },
+        { "fan_in", shape.fan_in },
+        { "scc_size", shape.scc_size },
+        { "layers", shape.layers },
+        { "sources_per_module", shape.sources_per_module },
+        { "headers_per_module", shape.headers_per_module },
+        { "header_weight", shape.header_weight },
+        { "seed", shape.seed }
+    };
+    json["root_module"] = generated.root_module;
+    json["modules"] = generated.modules;
+
+    return json.dump(4) + "\n";
+}
+
+generated_t generate(
+    const m03gagbhsnusi43zogoacgj2ez_filesystem::path_t& workspace_root,
+    const m03gagbhsnusi43zogoacgj2ez_filesystem::path_t& output_root,
+    const shape_t& shape
+) {
+    validate_shape(shape);
+    if (m03gagbhsnusi43zogoacgj2ez_filesystem::exists(output_root)) {
+        throw std::runtime_error(std::format("synthetic_workspace::generate: output root '{}' already exists", output_root));
+    }
+
+    const auto modules = make_modules(shape);
+
+    generated_t result {
+        .root = output_root,
+        .workspaces = { SEED_WORKSPACE },
+        .modules = {},
+        .root_module = modules.back().name
+    };
+    for (std::size_t layer = 0; layer <= modules.back().layer; ++layer) {
+        result.workspaces.push_back(layer_workspace(layer));
+    }
+    result.modules.reserve(modules.size() - 1);
+    for (std::size_t i = 0; i + 1 < modules.size(); ++i) {
+        result.modules.push_back(modules[i].name);
+    }
+
+    m03gagbhsnusi43zogoacgj2ez_filesystem::copy(
+        workspace_root / m03gagbhsnusi43zogoacgj2ez_filesystem::relative_path_t(SEED_WORKSPACE),
+        output_root / m03gagbhsnusi43zogoacgj2ez_filesystem::relative_path_t(SEED_WORKSPACE)
+    );
+
+    nlohmann::json workspaces_json;
+    workspaces_json["workspaces"] = result.workspaces;
+    write_file(output_root / m03gagbhsnusi43zogoacgj2ez_filesystem::relative_path_t(m03gagbhsp2drqq3gkop8pzfrm_workspace_graph::WORKSPACES_JSON), workspaces_json.dump(4) + "\n");
+
+    for (const auto& module : modules) {
+        write_module(output_root, modules, module, shape);
+    }
+
+    write_file(output_root / m03gagbhsnusi43zogoacgj2ez_filesystem::relative_path_t(MANIFEST_JSON), manifest_json(shape, result));
+
+    return result;
+}
+
+generated_t load(const m03gagbhsnusi43zogoacgj2ez_filesystem::path_t& output_root) {
+    const auto manifest_path = output_root / m03gagbhsnusi43zogoacgj2ez_filesystem::relative_path_t(MANIFEST_JSON);
+    std::ifstream ifs(manifest_path.string());
+    if (!ifs) {
+        throw std::runtime_error(std::format("synthetic_workspace::load: failed to open file '{}'", manifest_path));
+    }
+
+    try {
+        const auto json = nlohmann::json::parse(ifs);
+
+        const auto workspaces_path = output_root / m03gagbhsnusi43zogoacgj2ez_filesystem::relative_path_t(m03gagbhsp2drqq3gkop8pzfrm_workspace_graph::WORKSPACES_JSON);
+        std::ifstream workspaces_ifs(workspaces_path.string());
+        if (!workspaces_ifs) {
+            throw std::runtime_error(std::format("synthetic_workspace::load: failed to open file '{}'", workspaces_path));
+        }
+
+        return generated_t {
+            .root = output_root,
+            .workspaces = nlohmann::json::parse(workspaces_ifs).at("workspaces").get<std::vector<std::string>>(),
+            .modules = json.at("modules").get<std::vector<std::string>>(),
+            .root_module = json.at("root_module").get<std::string>()
+        };
+    } catch (const nlohmann::json::exception& e) {
+        throw std::runtime_error(std::format("synthetic_workspace::load: invalid manifest '{}': {}", manifest_path, e.what()));
+    }
+}
+
+} // namespace synthetic_workspace
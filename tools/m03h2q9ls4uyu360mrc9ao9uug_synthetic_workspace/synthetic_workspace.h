@@ -0,0 +1,79 @@
+#ifndef M03H2Q9LS4UYU360MRC9AO9UUG_SYNTHETIC_WORKSPACE_SYNTHETIC_WORKSPACE_H
+# define M03H2Q9LS4UYU360MRC9AO9UUG_SYNTHETIC_WORKSPACE_SYNTHETIC_WORKSPACE_H
+
+# include <m03gagbhsnusi43zogoacgj2ez_filesystem/filesystem.h>
+
+# include <cstddef>
+# include <cstdint>
+# include <string>
+# include <vector>
+
+namespace synthetic_workspace {
+
+inline const constexpr char* MANIFEST_JSON = "synthetic_workspace.json";
+
+/**
+ * Shape of a generated workspace.
+ *
+ * Modules are generated in groups of scc_size that depend on each other in a ring. Every module
+ * depends on up to fan_out modules of earlier groups, and no module gains more than fan_in
+ * dependents from later groups; fan_in 0 means unbounded. Groups are split evenly over layers
+ * workspaces in generation order, so dependencies never point to a later workspace.
+ */
+struct shape_t {
+    std::size_t modules = 1000;
+    std::size_t fan_out = 4;
+    std::size_t fan_in = 0;
+    std::size_t scc_size = 1;
+    std::size_t layers = 1;
+    std::size_t sources_per_module = 1;
+    std::size_t headers_per_module = 1;
+
+    /**
+     * Inline functions per generated header.
+     */
+    std::size_t header_weight = 8;
+
+    /**
+     * Seeds module names and dependency choices; equal shapes generate identical workspaces.
+     */
+    std::uint64_t seed = 1;
+};
+
+/**
+ * Generated workspace root, its workspaces and module names in generation order.
+ */
+struct generated_t {
+    m03gagbhsnusi43zogoacgj2ez_filesystem::path_t root;
+    std::vector<std::string> workspaces;
+    std::vector<std::string> modules;
+
+    /**
+     * Module that depends on every generated module no other generated module depends on.
+     *
+     * Building it builds the whole synthetic graph.
+     */
+    std::string root_module;
+};
+
+/**
+ * Writes a buildable workspace with the given shape under output_root, which must not exist.
+ *
+ * Copies the foundation workspace from workspace_root so the generated workspace bootstraps on
+ * its own, writes workspaces.json with the layer workspaces after it, and records the shape and
+ * module names in synthetic_workspace.json.
+ */
+generated_t generate(
+    const m03gagbhsnusi43zogoacgj2ez_filesystem::path_t& workspace_root,
+    const m03gagbhsnusi43zogoacgj2ez_filesystem::path_t& output_root,
+    const shape_t& shape
+);
+
+/**
+ * Reads back a workspace written by generate() from its workspaces.json and synthetic_workspace.json.
+ */
+generated_t load(const m03gagbhsnusi43zogoacgj2ez_filesystem::path_t& output_root);
+
+} // namespace synthetic_workspace
+
+#endif // M03H2Q9LS4UYU360MRC9AO9UUG_SYNTHETIC_WORKSPACE_SYNTHETIC_WORKSPACE_H
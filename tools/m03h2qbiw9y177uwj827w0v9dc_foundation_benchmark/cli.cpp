@@ -0,0 +1,111 @@
+#include <m03h2qbiw9y177uwj827w0v9dc_foundation_benchmark/foundation_benchmark.h>
+
+#include <m03gagbhsnusi43zogoacgj2ez_filesystem/filesystem.h>
+#include <m03gagbhsp2drqq3gkop8pzfrm_workspace_graph/workspace_graph.h>
+#include <m03h2q9ls4uyu360mrc9ao9uug_synthetic_workspace/synthetic_workspace.h>
+
+#include <exception>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <iostream>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+// Always installed when its own CLI runs, so it serves the no-op install benchmarks.
+static constexpr const char* MODULE_NAME = "m03h2qbiw9y177uwj827w0v9dc_foundation_benchmark";
+
+static void usage(const char* program) {
+    std::cerr << "usage: " << program << " [options]\n"
+              << "  --workspace <root>        workspace to measure (default: the current workspace)\n"
+              << "  --module <name>           module to discover (default: the synthetic root module, or this module)\n"
+              << "  --warmup <n>              untimed runs per benchmark (default 3)\n"
+              << "  --repetitions <n>         timed runs per benchmark (default 20)\n"
+              << "  --json <path>             also write results as JSON\n"
+              << "Relative paths are resolved against the workspace root.\n";
+}
+
+static m03gagbhsnusi43zogoacgj2ez_filesystem::path_t resolve(
+    const m03gagbhsp2drqq3gkop8pzfrm_workspace_graph::invocation_context_t& invocation_context,
+    std::string_view path
+) {
+    if (std::filesystem::path(path).is_absolute()) {
+        return m03gagbhsnusi43zogoacgj2ez_filesystem::path_t(path);
+    }
+
+    return invocation_context.workspace_root / m03gagbhsnusi43zogoacgj2ez_filesystem::relative_path_t(path);
+}
+
+int main(int argc, char** argv) {
+    if (argc % 2 != 1) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    try {
+        const auto invocation_context = m03gagbhsp2drqq3gkop8pzfrm_workspace_graph::invocation_context();
+
+        foundation_benchmark::options_t options;
+        std::optional<m03gagbhsnusi43zogoacgj2ez_filesystem::path_t> workspace_root;
+        std::optional<std::string> module;
+        std::optional<m03gagbhsnusi43zogoacgj2ez_filesystem::path_t> json_path;
+        for (int i = 1; i < argc; i += 2) {
+            const std::string_view option = argv[i];
+            const std::string_view value = argv[i + 1];
+            if (option == "--workspace") {
+                workspace_root = resolve(invocation_context, value);
+            } else if (option == "--module") {
+                module = std::string(value);
+            } else if (option == "--warmup") {
+                options.warmup = std::stoull(std::string(value));
+            } else if (option == "--repetitions") {
+                options.repetitions = std::stoull(std::string(value));
+            } else if (option == "--json") {
+                json_path = resolve(invocation_context, value);
+            } else {
+                usage(argv[0]);
+                return 1;
+            }
+        }
+
+        if (!workspace_root) {
+            workspace_root = invocation_context.workspace_root;
+        }
+        if (!module) {
+            const auto manifest = *workspace_root / m03gagbhsnusi43zogoacgj2ez_filesystem::relative_path_t(synthetic_workspace::MANIFEST_JSON);
+            module = m03gagbhsnusi43zogoacgj2ez_filesystem::exists(manifest) ? synthetic_workspace::load(*workspace_root).root_module : MODULE_NAME;
+        }
+
+        foundation_benchmark::harness_t harness(options);
+        foundation_benchmark::run_all(harness, foundation_benchmark::target_t {
+            .workspace_root = *workspace_root,
+            .artifact_root = invocation_context.artifact_root,
+            .module = m03gagbhsp2drqq3gkop8pzfrm_workspace_graph::module_name_t(*module),
+            .installed_module = m03gagbhsp2drqq3gkop8pzfrm_workspace_graph::module_name_t(MODULE_NAME)
+        });
+
+        std::cout << std::format("{:<48} {:>10} {:>12} {:>12} {:>12} {:>12}", "benchmark (ns/op)", "ops", "min", "p50", "p90", "p99") << std::endl;
+        for (const auto& result : harness.results()) {
+            std::cout << std::format("{:<48} {:>10} {:>12.1f} {:>12.1f} {:>12.1f} {:>12.1f}", result.name, result.operations, result.min_ns, result.p50_ns, result.p90_ns, result.p99_ns) << std::endl;
+        }
+
+        if (json_path) {
+            std::ofstream ofs(json_path->string(), std::ios::binary | std::ios::trunc);
+            if (!ofs) {
+                throw std::runtime_error(std::format("failed to open file '{}'", *json_path));
+            }
+
+            ofs << harness.json();
+            if (!ofs) {
+                throw std::runtime_error(std::format("failed to write file '{}'", *json_path));
+            }
+        }
+    } catch (const std::exception& e) {
+        std::cerr << std::format("{}: {}", argv[0], e.what()) << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,233 @@
+#include <m03h2qbiw9y177uwj827w0v9dc_foundation_benchmark/foundation_benchmark.h>
+
+#include <m03gagbhsmhr0naw0zpccv4gaq_cxx_toolchain/cxx_toolchain.h>
+#include <m03gagbhsqfsqblhwvelrou7nc_json/external/json.hpp>
+#include <m03gagbhsujjf63n0w3r2w4q6h_build_phases/build_phases.h>
+
+#include <algorithm>
+#include <chrono>
+#include <format>
+#include <memory>
+#include <numeric>
+#include <stdexcept>
+
+namespace foundation_benchmark {
+
+// Cap on paths fed to the path_t benchmarks, so a 50k-module tree does not dominate the run.
+static constexpr std::size_t MAX_PATH_SAMPLES = 4096;
+
+// Results are folded in here so the compiler cannot drop the measured calls.
+static volatile std::size_t g_sink;
+
+static double percentile(const std::vector<double>& sorted_samples, double fraction) {
+    const auto rank = static_cast<std::size_t>(fraction * static_cast<double>(sorted_samples.size() - 1) + 0.5);
+    return sorted_samples[rank];
+}
+
+harness_t::harness_t(options_t options):
+    m_options(options)
+{
+    if (m_options.repetitions == 0) {
+        throw std::runtime_error("foundation_benchmark::harness_t: repetitions must be positive");
+    }
+}
+
+void harness_t::run(
+    std::string_view name,
+    std::size_t operations,
+    const std::function<void()>& setup,
+    const std::function<void()>& body
+) {
+    if (operations == 0) {
+        throw std::runtime_error(std::format("foundation_benchmark::harness_t::run: benchmark '{}' has no operations", name));
+    }
+
+    std::vector<double> samples;
+    samples.reserve(m_options.repetitions);
+    for (std::size_t i = 0; i < m_options.warmup + m_options.repetitions; ++i) {
+        if (setup) {
+            setup();
+        }
+
+        const auto start = std::chrono::steady_clock::now();
+        body();
+        const auto elapsed = std::chrono::steady_clock::now() - start;
+
+        if (m_options.warmup <= i) {
+            samples.push_back(std::chrono::duration<double, std::nano>(elapsed).count() / static_cast<double>(operations));
+        }
+    }
+
+    std::sort(samples.begin(), samples.end());
+
+    m_results.push_back(result_t {
+        .name = std::string(name),
+        .operations = operations,
+        .min_ns = samples.front(),
+        .mean_ns = std::accumulate(samples.begin(), samples.end(), 0.0) / static_cast<double>(samples.size()),
+        .p50_ns = percentile(samples, 0.50),
+        .p90_ns = percentile(samples, 0.90),
+        .p99_ns = percentile(samples, 0.99),
+        .max_ns = samples.back()
+    });
+}
+
+void harness_t::run(std::string_view name, std::size_t operations, const std::function<void()>& body) {
+    run(name, operations, {}, body);
+}
+
+const options_t& harness_t::options() const {
+    return m_options;
+}
+
+const std::vector<result_t>& harness_t::results() const {
+    return m_results;
+}
+
+std::string harness_t::json() const {
+    nlohmann::ordered_json json;
+    json["warmup"] = m_options.warmup;
+    json["repetitions"] = m_options.repetitions;
+    json["unit"] = "ns/op";
+    json["benchmarks"] = nlohmann::ordered_json::array();
+    for (const auto& result : m_results) {
+        json["benchmarks"].push_back({
+            { "name", result.name },
+            { "operations", result.operations },
+            { "min", result.min_ns },
+            { "mean", result.mean_ns },
+            { "p50", result.p50_ns },
+            { "p90", result.p90_ns },
+            { "p99", result.p99_ns },
+            { "max", result.max_ns }
+        });
+    }
+
+    return json.dump(4) + "\n";
+}
+
+static std::vector<m03gagbhsnusi43zogoacgj2ez_filesystem::rooted_path_t> find_workspace_files(const target_t& target) {
+    // Skips the artifact root, which defaults to a directory inside the workspace root, and .git.
+    return m03gagbhsnusi43zogoacgj2ez_filesystem::find(
+        target.workspace_root,
+        m03gagbhsnusi43zogoacgj2ez_filesystem::find_include_predicate_t::is_regular,
+        m03gagbhsnusi43zogoacgj2ez_filesystem::find_descend_predicate_t([&](const m03gagbhsnusi43zogoacgj2ez_filesystem::path_t& dir, std::size_t) {
+            return dir != target.artifact_root && dir.filename() != ".git";
+        })
+    );
+}
+
+static void run_filesystem(harness_t& harness, const target_t& target) {
+    harness.run("filesystem::find", 1, [&]() {
+        g_sink = g_sink + find_workspace_files(target).size();
+    });
+
+    std::vector<std::string> strings;
+    std::vector<m03gagbhsnusi43zogoacgj2ez_filesystem::path_t> paths;
+    std::vector<m03gagbhsnusi43zogoacgj2ez_filesystem::relative_path_t> relative_paths;
+    for (const auto& found : find_workspace_files(target)) {
+        if (paths.size() == MAX_PATH_SAMPLES) {
+            break ;
+        }
+
+        strings.push_back(found.path().string());
+        paths.push_back(found.path());
+        relative_paths.push_back(found.relative_path());
+    }
+    if (paths.empty()) {
+        throw std::runtime_error(std::format("foundation_benchmark::run_all: workspace root '{}' has no files", target.workspace_root));
+    }
+
+    harness.run("path_t::path_t", strings.size(), [&]() {
+        for (const auto& string : strings) {
+            g_sink = g_sink + m03gagbhsnusi43zogoacgj2ez_filesystem::path_t(string).to_native_path().native().size();
+        }
+    });
+
+    harness.run("path_t::operator/", relative_paths.size(), [&]() {
+        for (const auto& relative_path : relative_paths) {
+            g_sink = g_sink + (target.workspace_root / relative_path).to_native_path().native().size();
+        }
+    });
+
+    harness.run("path_t::relative", paths.size(), [&]() {
+        for (const auto& path : paths) {
+            g_sink = g_sink + target.workspace_root.relative(path).to_native_path().native().size();
+        }
+    });
+}
+
+static void run_workspace_graph(harness_t& harness, const target_t& target) {
+    {
+        m03gagbhsp2drqq3gkop8pzfrm_workspace_graph::workspace_graph_t workspace_graph(target.workspace_root, target.artifact_root);
+        const auto source_dir = workspace_graph.discover_module(target.module)->source_dir();
+
+        harness.run("version_t(module source_dir)", 1, [&]() {
+            g_sink = g_sink + m03gagbhsp2drqq3gkop8pzfrm_workspace_graph::version_t(source_dir).value;
+        });
+    }
+
+    harness.run("workspace_graph_t::discover_module", 1, [&]() {
+        m03gagbhsp2drqq3gkop8pzfrm_workspace_graph::workspace_graph_t workspace_graph(target.workspace_root, target.artifact_root);
+        g_sink = g_sink + workspace_graph.discover_module(target.module)->index();
+    });
+
+    std::unique_ptr<m03gagbhsp2drqq3gkop8pzfrm_workspace_graph::workspace_graph_t> workspace_graph;
+    std::vector<const m03gagbhsp2drqq3gkop8pzfrm_workspace_graph::module_t*> modules;
+    const auto discover_all = [&]() {
+        workspace_graph = std::make_unique<m03gagbhsp2drqq3gkop8pzfrm_workspace_graph::workspace_graph_t>(target.workspace_root, target.artifact_root);
+        workspace_graph->discover_all_modules();
+        modules = workspace_graph->modules();
+    };
+    const auto closure_groups = [&]() {
+        for (const auto* module : modules) {
+            g_sink = g_sink + module->closure_groups().size();
+        }
+    };
+
+    discover_all();
+    const auto module_count = modules.size();
+    harness.run("module_t::closure_groups (first call)", module_count, discover_all, closure_groups);
+    harness.run("module_t::closure_groups (memoized)", module_count, closure_groups);
+}
+
+static void run_install(harness_t& harness, const target_t& target) {
+    const auto invocation_context = m03gagbhsp2drqq3gkop8pzfrm_workspace_graph::invocation_context();
+    m03gagbhsp2drqq3gkop8pzfrm_workspace_graph::workspace_graph_t workspace_graph(invocation_context.workspace_root, invocation_context.artifact_root);
+    auto& module = *workspace_graph.discover_module(target.installed_module);
+
+    const m03gagbhsujjf63n0w3r2w4q6h_build_phases::build_config_t build_config {
+        .library_type = m03gagbhsmhr0naw0zpccv4gaq_cxx_toolchain::library_type_t::SHARED
+    };
+    const auto phase = m03gagbhsujjf63n0w3r2w4q6h_build_phases::phase_base_t::make(module, build_config);
+
+    // Builds anything missing once, so every timed call finds its manifest.
+    phase->install<m03gagbhsujjf63n0w3r2w4q6h_build_phases::binary_phase_t>();
+
+    harness.run("phase_base_t::install<binary_phase_t> (complete)", 1, [&]() {
+        g_sink = g_sink + phase->install<m03gagbhsujjf63n0w3r2w4q6h_build_phases::binary_phase_t>().cli().string().size();
+    });
+
+    std::size_t closure_size = 0;
+    for (const auto& group : module.closure_groups()) {
+        closure_size += group.size();
+    }
+
+    // Mirrors phase_base_t::install_closure<library_phase_t>(), which is protected.
+    harness.run("install closure<library_phase_t> (complete)", closure_size, [&]() {
+        for (const auto& group : module.closure_groups()) {
+            for (auto* dependency : group) {
+                const auto dependency_phase = m03gagbhsujjf63n0w3r2w4q6h_build_phases::phase_base_t::make(*dependency, build_config);
+                g_sink = g_sink + dependency_phase->install<m03gagbhsujjf63n0w3r2w4q6h_build_phases::library_phase_t>().root().string().size();
+            }
+        }
+    });
+}
+
+void run_all(harness_t& harness, const target_t& target) {
+    run_filesystem(harness, target);
+    run_workspace_graph(harness, target);
+    run_install(harness, target);
+}
+
+} // namespace foundation_benchmark
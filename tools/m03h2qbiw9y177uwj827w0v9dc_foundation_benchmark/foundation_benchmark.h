@@ -0,0 +1,105 @@
+#ifndef M03H2QBIW9Y177UWJ827W0V9DC_FOUNDATION_BENCHMARK_FOUNDATION_BENCHMARK_H
+# define M03H2QBIW9Y177UWJ827W0V9DC_FOUNDATION_BENCHMARK_FOUNDATION_BENCHMARK_H
+
+# include <m03gagbhsnusi43zogoacgj2ez_filesystem/filesystem.h>
+# include <m03gagbhsp2drqq3gkop8pzfrm_workspace_graph/workspace_graph.h>
+
+# include <cstddef>
+# include <functional>
+# include <string>
+# include <string_view>
+# include <vector>
+
+namespace foundation_benchmark {
+
+/**
+ * Untimed warmup runs and timed repetitions per benchmark.
+ */
+struct options_t {
+    std::size_t warmup = 3;
+    std::size_t repetitions = 20;
+};
+
+/**
+ * Per-operation nanoseconds over the timed repetitions of one benchmark.
+ */
+struct result_t {
+    std::string name;
+
+    /**
+     * Operations per repetition; each sample is a repetition's time divided by this.
+     */
+    std::size_t operations;
+
+    double min_ns;
+    double mean_ns;
+    double p50_ns;
+    double p90_ns;
+    double p99_ns;
+    double max_ns;
+};
+
+/**
+ * Runs benchmarks with the same options and collects their results.
+ */
+class harness_t {
+public:
+    explicit harness_t(options_t options);
+
+    /**
+     * Runs setup untimed and then body timed, options.warmup + options.repetitions times.
+     *
+     * body performs operations operations; results are reported per operation.
+     */
+    void run(
+        std::string_view name,
+        std::size_t operations,
+        const std::function<void()>& setup,
+        const std::function<void()>& body
+    );
+
+    /**
+     * run() without per-repetition setup.
+     */
+    void run(std::string_view name, std::size_t operations, const std::function<void()>& body);
+
+    const options_t& options() const;
+    const std::vector<result_t>& results() const;
+
+    /**
+     * Options and results as a JSON document.
+     */
+    std::string json() const;
+
+private:
+    options_t m_options;
+    std::vector<result_t> m_results;
+};
+
+/**
+ * Inputs for the foundation hot path benchmarks.
+ */
+struct target_t {
+    /**
+     * Workspace whose tree, graph and versions are measured; may be a synthetic workspace.
+     */
+    m03gagbhsnusi43zogoacgj2ez_filesystem::path_t workspace_root;
+    m03gagbhsnusi43zogoacgj2ez_filesystem::path_t artifact_root;
+    m03gagbhsp2drqq3gkop8pzfrm_workspace_graph::module_name_t module;
+
+    /**
+     * Module in the invocation workspace whose phases are already installed, used for the no-op
+     * install benchmarks.
+     */
+    m03gagbhsp2drqq3gkop8pzfrm_workspace_graph::module_name_t installed_module;
+};
+
+/**
+ * Benchmarks filesystem::find, path_t construction, operator/ and relative(), version_t(directory),
+ * discover_module, closure_groups and no-op phase installs.
+ */
+void run_all(harness_t& harness, const target_t& target);
+
+} // namespace foundation_benchmark
+
+#endif // M03H2QBIW9Y177UWJ827W0V9DC_FOUNDATION_BENCHMARK_FOUNDATION_BENCHMARK_H
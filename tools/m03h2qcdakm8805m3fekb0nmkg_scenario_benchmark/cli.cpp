@@ -0,0 +1,115 @@
+#include <m03h2qcdakm8805m3fekb0nmkg_scenario_benchmark/scenario_benchmark.h>
+
+#include <m03gagbhsnusi43zogoacgj2ez_filesystem/filesystem.h>
+#include <m03gagbhsp2drqq3gkop8pzfrm_workspace_graph/workspace_graph.h>
+
+#include <exception>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <iostream>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+static void usage(const char* program) {
+    std::cerr << "usage: " << program << " <fixture-root> [options]\n"
+              << "  --repetitions <n>         runs per scenario (default 1)\n"
+              << "  --artifact-root <path>    artifact root, removed before each cold build (default <fixture-root>/artifacts)\n"
+              << "  --scratch-root <path>     scratch root, removed before each cold build (default <fixture-root>/scratch)\n"
+              << "  --cli <path>              Builder CLI to run (default <workspace-root>/cli)\n"
+              << "  --json <path>             write results as JSON\n"
+              << "  --baseline <path>         compare medians against an earlier --json file\n"
+              << "  --threshold <fraction>    allowed growth over the baseline (default 0.1)\n"
+              << "Relative paths are resolved against the workspace root. Exits with 2 when a metric regresses.\n";
+}
+
+static m03gagbhsnusi43zogoacgj2ez_filesystem::path_t resolve(
+    const m03gagbhsp2drqq3gkop8pzfrm_workspace_graph::invocation_context_t& invocation_context,
+    std::string_view path
+) {
+    if (std::filesystem::path(path).is_absolute()) {
+        return m03gagbhsnusi43zogoacgj2ez_filesystem::path_t(path);
+    }
+
+    return invocation_context.workspace_root / m03gagbhsnusi43zogoacgj2ez_filesystem::relative_path_t(path);
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2 || argc % 2 != 0 || std::string_view(argv[1]).starts_with("--")) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    try {
+        const auto invocation_context = m03gagbhsp2drqq3gkop8pzfrm_workspace_graph::invocation_context();
+        const auto fixture_root = resolve(invocation_context, argv[1]);
+
+        scenario_benchmark::options_t options {
+            .cli = invocation_context.workspace_root / m03gagbhsnusi43zogoacgj2ez_filesystem::relative_path_t("cli"),
+            .fixture_root = fixture_root,
+            .artifact_root = fixture_root / m03gagbhsnusi43zogoacgj2ez_filesystem::relative_path_t("artifacts"),
+            .scratch_root = fixture_root / m03gagbhsnusi43zogoacgj2ez_filesystem::relative_path_t("scratch")
+        };
+        std::optional<m03gagbhsnusi43zogoacgj2ez_filesystem::path_t> json_path;
+        std::optional<m03gagbhsnusi43zogoacgj2ez_filesystem::path_t> baseline_path;
+        double threshold = 0.1;
+        for (int i = 2; i < argc; i += 2) {
+            const std::string_view option = argv[i];
+            const std::string_view value = argv[i + 1];
+            if (option == "--repetitions") {
+                options.repetitions = std::stoull(std::string(value));
+            } else if (option == "--artifact-root") {
+                options.artifact_root = resolve(invocation_context, value);
+            } else if (option == "--scratch-root") {
+                options.scratch_root = resolve(invocation_context, value);
+            } else if (option == "--cli") {
+                options.cli = resolve(invocation_context, value);
+            } else if (option == "--json") {
+                json_path = resolve(invocation_context, value);
+            } else if (option == "--baseline") {
+                baseline_path = resolve(invocation_context, value);
+            } else if (option == "--threshold") {
+                threshold = std::stod(std::string(value));
+            } else {
+                usage(argv[0]);
+                return 1;
+            }
+        }
+
+        const auto results = scenario_benchmark::run(options);
+
+        std::cout << std::format("{:<24} {:>12} {:>12} {:>10} {:>14}", "scenario (median)", "wall ms", "cpu ms", "processes", "bytes written") << std::endl;
+        for (const auto& result : results) {
+            std::cout << std::format("{:<24} {:>12.1f} {:>12.1f} {:>10} {:>14}", result.name, result.median.wall_ms, result.median.cpu_ms, result.median.processes, result.median.bytes_written) << std::endl;
+        }
+
+        if (json_path) {
+            std::ofstream ofs(json_path->string(), std::ios::binary | std::ios::trunc);
+            if (!ofs) {
+                throw std::runtime_error(std::format("failed to open file '{}'", *json_path));
+            }
+
+            ofs << scenario_benchmark::json(results);
+            if (!ofs) {
+                throw std::runtime_error(std::format("failed to write file '{}'", *json_path));
+            }
+        }
+
+        if (baseline_path) {
+            const auto regressions = scenario_benchmark::compare(*baseline_path, results, threshold);
+            for (const auto& regression : regressions) {
+                std::cerr << std::format("regression: {} {}: {:.1f} -> {:.1f}", regression.scenario, regression.metric, regression.baseline, regression.current) << std::endl;
+            }
+            if (!regressions.empty()) {
+                return 2;
+            }
+        }
+    } catch (const std::exception& e) {
+        std::cerr << std::format("{}: {}", argv[0], e.what()) << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
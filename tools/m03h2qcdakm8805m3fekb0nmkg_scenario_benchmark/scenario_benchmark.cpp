@@ -0,0 +1,234 @@
+#include <m03h2qcdakm8805m3fekb0nmkg_scenario_benchmark/scenario_benchmark.h>
+
+#include <m03gagbhsp2drqq3gkop8pzfrm_workspace_graph/workspace_graph.h>
+#include <m03gagbhsqfsqblhwvelrou7nc_json/external/json.hpp>
+#include <m03gagbhsvr0m5w15urj0o291m_process/process.h>
+#include <m03h2q9ls4uyu360mrc9ao9uug_synthetic_workspace/synthetic_workspace.h>
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <format>
+#include <functional>
+#include <iterator>
+#include <stdexcept>
+#include <string_view>
+
+#include <sys/resource.h>
+
+namespace scenario_benchmark {
+
+struct counters_t {
+    std::chrono::steady_clock::time_point wall;
+    double cpu_ms;
+    std::uint64_t processes;
+    std::uint64_t bytes_written;
+};
+
+static std::uint64_t read_proc_counter(const char* path, std::string_view key) {
+    std::ifstream ifs(path);
+    if (!ifs) {
+        throw std::runtime_error(std::format("scenario_benchmark::read_proc_counter: failed to open file '{}'", path));
+    }
+
+    for (std::string line; std::getline(ifs, line);) {
+        if (line.starts_with(key)) {
+            return std::stoull(line.substr(key.size()));
+        }
+    }
+
+    throw std::runtime_error(std::format("scenario_benchmark::read_proc_counter: '{}' has no '{}' entry", path, key));
+}
+
+static counters_t read_counters() {
+    rusage usage;
+    if (getrusage(RUSAGE_CHILDREN, &usage) == -1) {
+        throw std::runtime_error("scenario_benchmark::read_counters: getrusage failed");
+    }
+
+    const auto to_ms = [](const timeval& time) {
+        return static_cast<double>(time.tv_sec) * 1000.0 + static_cast<double>(time.tv_usec) / 1000.0;
+    };
+
+    return counters_t {
+        .wall = std::chrono::steady_clock::now(),
+        .cpu_ms = to_ms(usage.ru_utime) + to_ms(usage.ru_stime),
+        .processes = read_proc_counter("/proc/stat", "processes "),
+        .bytes_written = read_proc_counter("/proc/self/io", "wchar: ")
+    };
+}
+
+static measurement_t measure(const options_t& options, const std::string& target_module) {
+    const auto before = read_counters();
+    m03gagbhsvr0m5w15urj0o291m_process::create_and_wait_checked(m03gagbhsvr0m5w15urj0o291m_process::command_t {
+        .args = { options.cli, target_module },
+        .working_dir = options.fixture_root,
+        .environment = {
+            { "BUILDER_WORKSPACE_ROOT", options.fixture_root.string() },
+            { "BUILDER_ARTIFACT_ROOT", options.artifact_root.string() },
+            { "BUILDER_SCRATCH_ROOT", options.scratch_root.string() }
+        }
+    });
+    const auto after = read_counters();
+
+    return measurement_t {
+        .wall_ms = std::chrono::duration<double, std::milli>(after.wall - before.wall).count(),
+        .cpu_ms = after.cpu_ms - before.cpu_ms,
+        .processes = after.processes - before.processes,
+        .bytes_written = after.bytes_written - before.bytes_written
+    };
+}
+
+template <class value_t>
+static value_t median_of(const std::vector<measurement_t>& samples, value_t measurement_t::* metric) {
+    std::vector<value_t> values;
+    values.reserve(samples.size());
+    for (const auto& sample : samples) {
+        values.push_back(sample.*metric);
+    }
+
+    std::sort(values.begin(), values.end());
+    return values[values.size() / 2];
+}
+
+static measurement_t median(const std::vector<measurement_t>& samples) {
+    return measurement_t {
+        .wall_ms = median_of(samples, &measurement_t::wall_ms),
+        .cpu_ms = median_of(samples, &measurement_t::cpu_ms),
+        .processes = median_of(samples, &measurement_t::processes),
+        .bytes_written = median_of(samples, &measurement_t::bytes_written)
+    };
+}
+
+std::vector<scenario_result_t> run(const options_t& options) {
+    if (options.repetitions == 0) {
+        throw std::runtime_error("scenario_benchmark::run: repetitions must be positive");
+    }
+    if (options.artifact_root == options.fixture_root || options.artifact_root.is_child(options.fixture_root)) {
+        throw std::runtime_error(std::format("scenario_benchmark::run: artifact root '{}' must not contain the fixture", options.artifact_root));
+    }
+    if (options.scratch_root == options.fixture_root || options.scratch_root.is_child(options.fixture_root)) {
+        throw std::runtime_error(std::format("scenario_benchmark::run: scratch root '{}' must not contain the fixture", options.scratch_root));
+    }
+
+    const auto fixture = synthetic_workspace::load(options.fixture_root);
+    if (fixture.modules.empty()) {
+        throw std::runtime_error(std::format("scenario_benchmark::run: fixture '{}' has no modules", options.fixture_root));
+    }
+
+    m03gagbhsp2drqq3gkop8pzfrm_workspace_graph::workspace_graph_t workspace_graph(options.fixture_root, options.artifact_root);
+    const auto* root_module = workspace_graph.discover_module(m03gagbhsp2drqq3gkop8pzfrm_workspace_graph::module_name_t(fixture.root_module));
+    if (root_module->dependencies().empty()) {
+        throw std::runtime_error(std::format("scenario_benchmark::run: root module '{}' has no dependencies", fixture.root_module));
+    }
+
+    // The root module depends only on modules that nothing else depends on.
+    const auto leaf_source = root_module->dependencies().back()->source_dir() / m03gagbhsnusi43zogoacgj2ez_filesystem::relative_path_t("s0.cpp");
+    const auto low_level_header = workspace_graph.discover_module(m03gagbhsp2drqq3gkop8pzfrm_workspace_graph::module_name_t(fixture.modules.front()))->source_dir() / m03gagbhsnusi43zogoacgj2ez_filesystem::relative_path_t("h0.h");
+
+    struct scenario_t {
+        const char* name;
+        std::function<void()> prepare;
+    };
+    const scenario_t scenarios[] = {
+        { "cold", [&]() {
+            for (const auto& root : { options.artifact_root, options.scratch_root }) {
+                if (m03gagbhsnusi43zogoacgj2ez_filesystem::exists(root)) {
+                    m03gagbhsnusi43zogoacgj2ez_filesystem::remove_all(root);
+                }
+            }
+        } },
+        { "no_op", []() {} },
+        { "touch_leaf_source", [&]() { m03gagbhsnusi43zogoacgj2ez_filesystem::touch(leaf_source); } },
+        { "touch_low_level_header", [&]() { m03gagbhsnusi43zogoacgj2ez_filesystem::touch(low_level_header); } }
+    };
+
+    std::vector<scenario_result_t> results;
+    for (const auto& scenario : scenarios) {
+        results.push_back(scenario_result_t { .name = scenario.name, .samples = {}, .median = {} });
+    }
+
+    // Every repetition replays the scenarios in order, so each starts from the state the previous one left.
+    for (std::size_t repetition = 0; repetition < options.repetitions; ++repetition) {
+        for (std::size_t i = 0; i < std::size(scenarios); ++i) {
+            scenarios[i].prepare();
+            results[i].samples.push_back(measure(options, fixture.root_module));
+        }
+    }
+
+    for (auto& result : results) {
+        result.median = median(result.samples);
+    }
+
+    return results;
+}
+
+static nlohmann::ordered_json measurement_json(const measurement_t& measurement) {
+    return {
+        { "wall_ms", measurement.wall_ms },
+        { "cpu_ms", measurement.cpu_ms },
+        { "processes", measurement.processes },
+        { "bytes_written", measurement.bytes_written }
+    };
+}
+
+std::string json(const std::vector<scenario_result_t>& results) {
+    nlohmann::ordered_json json;
+    json["scenarios"] = nlohmann::ordered_json::array();
+    for (const auto& result : results) {
+        nlohmann::ordered_json scenario;
+        scenario["name"] = result.name;
+        scenario["median"] = measurement_json(result.median);
+        scenario["samples"] = nlohmann::ordered_json::array();
+        for (const auto& sample : result.samples) {
+            scenario["samples"].push_back(measurement_json(sample));
+        }
+        json["scenarios"].push_back(std::move(scenario));
+    }
+
+    return json.dump(4) + "\n";
+}
+
+std::vector<regression_t> compare(
+    const m03gagbhsnusi43zogoacgj2ez_filesystem::path_t& baseline,
+    const std::vector<scenario_result_t>& results,
+    double threshold
+) {
+    std::ifstream ifs(baseline.string());
+    if (!ifs) {
+        throw std::runtime_error(std::format("scenario_benchmark::compare: failed to open file '{}'", baseline));
+    }
+
+    std::vector<regression_t> regressions;
+    try {
+        const auto json = nlohmann::json::parse(ifs);
+        for (const auto& result : results) {
+            const auto scenario = std::find_if(json.at("scenarios").begin(), json.at("scenarios").end(), [&](const nlohmann::json& candidate) {
+                return candidate.at("name").get<std::string>() == result.name;
+            });
+            if (scenario == json.at("scenarios").end()) {
+                continue ;
+            }
+
+            const auto current = measurement_json(result.median);
+            for (const auto& [metric, value] : current.items()) {
+                const auto baseline_value = scenario->at("median").at(metric).get<double>();
+                const auto current_value = value.get<double>();
+                if (baseline_value * (1.0 + threshold) < current_value) {
+                    regressions.push_back(regression_t {
+                        .scenario = result.name,
+                        .metric = metric,
+                        .baseline = baseline_value,
+                        .current = current_value
+                    });
+                }
+            }
+        }
+    } catch (const nlohmann::json::exception& e) {
+        throw std::runtime_error(std::format("scenario_benchmark::compare: invalid baseline '{}': {}", baseline, e.what()));
+    }
+
+    return regressions;
+}
+
+} // namespace scenario_benchmark
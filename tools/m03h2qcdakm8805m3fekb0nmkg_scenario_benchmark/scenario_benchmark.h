@@ -0,0 +1,106 @@
+#ifndef M03H2QCDAKM8805M3FEKB0NMKG_SCENARIO_BENCHMARK_SCENARIO_BENCHMARK_H
+# define M03H2QCDAKM8805M3FEKB0NMKG_SCENARIO_BENCHMARK_SCENARIO_BENCHMARK_H
+
+# include <m03gagbhsnusi43zogoacgj2ez_filesystem/filesystem.h>
+
+# include <cstddef>
+# include <cstdint>
+# include <string>
+# include <vector>
+
+namespace scenario_benchmark {
+
+/**
+ * Cost of one ./cli run.
+ */
+struct measurement_t {
+    double wall_ms;
+
+    /**
+     * User plus system time of ./cli and every process it waited for.
+     */
+    double cpu_ms;
+
+    /**
+     * Processes forked system-wide while ./cli ran, from /proc/stat; exact on an otherwise idle machine.
+     */
+    std::uint64_t processes;
+
+    /**
+     * Bytes passed to write calls by ./cli and its reaped descendants, from /proc/self/io wchar.
+     */
+    std::uint64_t bytes_written;
+};
+
+/**
+ * Samples of one scenario and their per-metric medians.
+ */
+struct scenario_result_t {
+    std::string name;
+    std::vector<measurement_t> samples;
+    measurement_t median;
+};
+
+/**
+ * Fixture, ./cli, artifact root and scratch root for a scenario run.
+ */
+struct options_t {
+    /**
+     * Builder CLI to run; normally <workspace_root>/cli.
+     */
+    m03gagbhsnusi43zogoacgj2ez_filesystem::path_t cli;
+
+    /**
+     * Workspace written by synthetic_workspace; its root module is the build target.
+     */
+    m03gagbhsnusi43zogoacgj2ez_filesystem::path_t fixture_root;
+
+    /**
+     * BUILDER_ARTIFACT_ROOT for every run; removed before each cold build.
+     */
+    m03gagbhsnusi43zogoacgj2ez_filesystem::path_t artifact_root;
+
+    /**
+     * BUILDER_SCRATCH_ROOT for every run, so builds never reuse the invoking builder's scratch; removed before
+     * each cold build.
+     */
+    m03gagbhsnusi43zogoacgj2ez_filesystem::path_t scratch_root;
+
+    std::size_t repetitions = 1;
+};
+
+/**
+ * Builds the fixture root module repetitions times in each of four scenarios, in order:
+ * cold (empty artifact and scratch roots), no_op (nothing changed), touch_leaf_source (a .cpp of a module only
+ * the root module depends on), and touch_low_level_header (a header of the first generated module).
+ */
+std::vector<scenario_result_t> run(const options_t& options);
+
+/**
+ * Scenario results as a JSON document, the format compare() reads as a baseline.
+ */
+std::string json(const std::vector<scenario_result_t>& results);
+
+/**
+ * Median metric that grew beyond the allowed threshold relative to the baseline.
+ */
+struct regression_t {
+    std::string scenario;
+    std::string metric;
+    double baseline;
+    double current;
+};
+
+/**
+ * Compares medians against a baseline written by json(); a metric regresses when
+ * current > baseline * (1 + threshold). Scenarios missing from the baseline are skipped.
+ */
+std::vector<regression_t> compare(
+    const m03gagbhsnusi43zogoacgj2ez_filesystem::path_t& baseline,
+    const std::vector<scenario_result_t>& results,
+    double threshold
+);
+
+} // namespace scenario_benchmark
+
+#endif // M03H2QCDAKM8805M3FEKB0NMKG_SCENARIO_BENCHMARK_SCENARIO_BENCHMARK_H
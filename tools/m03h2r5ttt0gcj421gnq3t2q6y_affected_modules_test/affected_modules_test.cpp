@@ -0,0 +1,122 @@
+#include <m03h2r5ttt0gcj421gnq3t2q6y_affected_modules_test/affected_modules_test.h>
+
+#include <m03gagbhsnusi43zogoacgj2ez_filesystem/filesystem.h>
+#include <m03h2q8sfii7rvt7t1hr1e0van_affected_modules/affected_modules.h>
+
+#include <algorithm>
+#include <format>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace affected_modules_test {
+
+static constexpr const char* AFFECTED_MODULES_MODULE = "m03h2q8sfii7rvt7t1hr1e0van_affected_modules";
+
+// Reached by the bootstrap seed, but not the seed itself.
+static constexpr const char* FILESYSTEM_MODULE = "m03gagbhsnusi43zogoacgj2ez_filesystem";
+
+static std::vector<const m03gagbhsp2drqq3gkop8pzfrm_workspace_graph::module_t*> modules_of(const affected_modules::affected_t& affected) {
+    std::vector<const m03gagbhsp2drqq3gkop8pzfrm_workspace_graph::module_t*> result;
+    for (const auto& affected_module : affected.modules) {
+        result.push_back(affected_module.module);
+    }
+
+    return result;
+}
+
+static bool is_changed(const affected_modules::affected_t& affected, const m03gagbhsp2drqq3gkop8pzfrm_workspace_graph::module_t& module) {
+    return std::any_of(affected.modules.begin(), affected.modules.end(), [&](const affected_modules::affected_module_t& affected_module) {
+        return affected_module.module == &module && affected_module.changed;
+    });
+}
+
+/**
+ * Expects changed_path to affect exactly expected, with only changed_module marked changed when it is set.
+ */
+static void expect_affected(
+    m03gagbhsp2drqq3gkop8pzfrm_workspace_graph::workspace_graph_t& workspace_graph,
+    const m03gagbhsnusi43zogoacgj2ez_filesystem::path_t& changed_path,
+    const std::vector<const m03gagbhsp2drqq3gkop8pzfrm_workspace_graph::module_t*>& expected,
+    const m03gagbhsp2drqq3gkop8pzfrm_workspace_graph::module_t* changed_module,
+    std::vector<std::string>& failures
+) {
+    const auto affected = affected_modules::find_affected(workspace_graph, { changed_path });
+
+    if (!affected.unowned_paths.empty()) {
+        failures.push_back(std::format("'{}': reported as not inside a module", changed_path));
+    }
+
+    if (modules_of(affected) != expected) {
+        failures.push_back(std::format("'{}': affects {} modules, expected {}", changed_path, affected.modules.size(), expected.size()));
+    }
+
+    if (changed_module != nullptr) {
+        for (const auto& affected_module : affected.modules) {
+            if (affected_module.changed != (affected_module.module == changed_module)) {
+                failures.push_back(std::format("'{}': module '{}' is reported {}", changed_path, affected_module.module->name(), affected_module.changed ? "changed" : "dependent"));
+            }
+        }
+    }
+}
+
+std::vector<std::string> run(m03gagbhsp2drqq3gkop8pzfrm_workspace_graph::workspace_graph_t& workspace_graph) {
+    std::vector<std::string> failures;
+
+    workspace_graph.discover_all_modules();
+    const auto all_modules = std::as_const(workspace_graph).modules();
+    const auto& bootstrap_seed_module = workspace_graph.bootstrap_seed_module();
+    const auto& filesystem_module = *workspace_graph.discover_module(m03gagbhsp2drqq3gkop8pzfrm_workspace_graph::module_name_t(FILESYSTEM_MODULE));
+    const auto& affected_modules_module = *workspace_graph.discover_module(m03gagbhsp2drqq3gkop8pzfrm_workspace_graph::module_name_t(AFFECTED_MODULES_MODULE));
+
+    const auto workspaces_json = workspace_graph.root() / m03gagbhsnusi43zogoacgj2ez_filesystem::relative_path_t(m03gagbhsp2drqq3gkop8pzfrm_workspace_graph::WORKSPACES_JSON);
+    const auto workspaces_json_affected = affected_modules::find_affected(workspace_graph, { workspaces_json });
+    if (modules_of(workspaces_json_affected) != all_modules || !is_changed(workspaces_json_affected, bootstrap_seed_module)) {
+        failures.push_back(std::format("'{}': expected every module to be changed", workspaces_json));
+    }
+
+    expect_affected(
+        workspace_graph,
+        bootstrap_seed_module.source_dir() / m03gagbhsnusi43zogoacgj2ez_filesystem::relative_path_t(m03gagbhsp2drqq3gkop8pzfrm_workspace_graph::CLI_CPP),
+        all_modules,
+        &bootstrap_seed_module,
+        failures
+    );
+
+    if (!workspace_graph.reaches(bootstrap_seed_module, filesystem_module)) {
+        failures.push_back(std::format("module '{}' is no longer reached by the bootstrap seed", filesystem_module.name()));
+    }
+    expect_affected(
+        workspace_graph,
+        filesystem_module.source_dir() / m03gagbhsnusi43zogoacgj2ez_filesystem::relative_path_t("deps.json"),
+        all_modules,
+        &filesystem_module,
+        failures
+    );
+
+    // Outside the bootstrap seed's reach, a change affects only the module and its dependents.
+    if (workspace_graph.reaches(bootstrap_seed_module, affected_modules_module)) {
+        failures.push_back(std::format("module '{}' is reached by the bootstrap seed", affected_modules_module.name()));
+    }
+    const auto dependents = workspace_graph.dependents(affected_modules_module);
+    std::vector<const m03gagbhsp2drqq3gkop8pzfrm_workspace_graph::module_t*> affected_by_affected_modules;
+    for (const auto* module : all_modules) {
+        if (module == &affected_modules_module || std::find(dependents.begin(), dependents.end(), module) != dependents.end()) {
+            affected_by_affected_modules.push_back(module);
+        }
+    }
+    if (affected_by_affected_modules.size() == all_modules.size()) {
+        failures.push_back(std::format("module '{}' is depended on by every module", affected_modules_module.name()));
+    }
+    expect_affected(
+        workspace_graph,
+        affected_modules_module.source_dir() / m03gagbhsnusi43zogoacgj2ez_filesystem::relative_path_t("affected_modules.cpp"),
+        affected_by_affected_modules,
+        &affected_modules_module,
+        failures
+    );
+
+    return failures;
+}
+
+} // namespace affected_modules_test
@@ -0,0 +1,21 @@
+#ifndef M03H2R5TTT0GCJ421GNQ3T2Q6Y_AFFECTED_MODULES_TEST_AFFECTED_MODULES_TEST_H
+# define M03H2R5TTT0GCJ421GNQ3T2Q6Y_AFFECTED_MODULES_TEST_AFFECTED_MODULES_TEST_H
+
+# include <m03gagbhsp2drqq3gkop8pzfrm_workspace_graph/workspace_graph.h>
+
+# include <string>
+# include <vector>
+
+namespace affected_modules_test {
+
+/**
+ * Checks affected_modules::find_affected() against workspace_graph and returns a message per failed expectation.
+ *
+ * Covers changes to workspaces.json, to the bootstrap seed and to a module the seed reaches, which affect
+ * every module, and a change to affected_modules itself, which affects only its dependents.
+ */
+std::vector<std::string> run(m03gagbhsp2drqq3gkop8pzfrm_workspace_graph::workspace_graph_t& workspace_graph);
+
+} // namespace affected_modules_test
+
+#endif // M03H2R5TTT0GCJ421GNQ3T2Q6Y_AFFECTED_MODULES_TEST_AFFECTED_MODULES_TEST_H
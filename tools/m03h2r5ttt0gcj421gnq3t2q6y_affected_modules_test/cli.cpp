@@ -0,0 +1,37 @@
+#include <m03h2r5ttt0gcj421gnq3t2q6y_affected_modules_test/affected_modules_test.h>
+
+#include <m03gagbhsp2drqq3gkop8pzfrm_workspace_graph/workspace_graph.h>
+
+#include <exception>
+#include <format>
+#include <iostream>
+
+int main(int argc, char** argv) {
+    if (argc != 1) {
+        std::cerr << "usage: " << argv[0] << "\n"
+                  << "Checks the affected_modules query against the current workspace.\n";
+        return 1;
+    }
+
+    try {
+        const auto invocation_context = m03gagbhsp2drqq3gkop8pzfrm_workspace_graph::invocation_context();
+        m03gagbhsp2drqq3gkop8pzfrm_workspace_graph::workspace_graph_t workspace_graph(
+            invocation_context.workspace_root,
+            invocation_context.artifact_root
+        );
+
+        const auto failures = affected_modules_test::run(workspace_graph);
+        for (const auto& failure : failures) {
+            std::cerr << std::format("{}: {}", argv[0], failure) << std::endl;
+        }
+        if (!failures.empty()) {
+            return 1;
+        }
+    } catch (const std::exception& e) {
+        std::cerr << std::format("{}: {}", argv[0], e.what()) << std::endl;
+        return 1;
+    }
+
+    std::cout << "ok" << std::endl;
+    return 0;
+}